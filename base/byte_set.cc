@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "byte_set.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OCOS_BYTESET_AVX2
+#define OCOS_BYTESET_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCOS_BYTESET_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCOS_BYTESET_NEON
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ort_extensions {
+namespace {
+
+inline unsigned CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+}  // namespace
+
+ByteSet::ByteSet(std::string_view members) {
+  int group_of_high_nibble[16];
+  for (auto& g : group_of_high_nibble) {
+    g = -1;
+  }
+  int num_groups = 0;
+  nibble_lookup_ = true;
+  for (char c : members) {
+    uint8_t b = static_cast<uint8_t>(c);
+    if (table_[b]) {
+      continue;
+    }
+    table_[b] = true;
+    if (num_members_ < sizeof(members_)) {
+      members_[num_members_] = b;
+    }
+    ++num_members_;
+
+    int& group = group_of_high_nibble[b >> 4];
+    if (group < 0) {
+      if (num_groups == 8) {
+        nibble_lookup_ = false;
+        continue;
+      }
+      group = num_groups++;
+      high_nibbles_[b >> 4] = static_cast<uint8_t>(1u << group);
+    }
+    low_nibbles_[b & 0x0F] |= static_cast<uint8_t>(1u << group);
+  }
+}
+
+size_t ByteSet::FindFirst(const char* data, size_t len, size_t from) const noexcept {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  size_t i = from;
+  if (num_members_ == 0) {
+    return len;
+  }
+
+#if defined(OCOS_BYTESET_AVX2)
+  if (nibble_lookup_) {
+    const __m256i low_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(low_nibbles_)));
+    const __m256i high_table =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(high_nibbles_)));
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 32 <= len; i += 32) {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+      const __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(v, nibble_mask));
+      const __m256i high = _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask));
+      const __m256i hit = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), zero);
+      const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+      if (mask != 0) {
+        return i + CountTrailingZeros(mask);
+      }
+    }
+  }
+#endif
+#if defined(OCOS_BYTESET_SSE2)
+  if (num_members_ <= sizeof(members_)) {
+    __m128i m[sizeof(members_)];
+    for (size_t k = 0; k < sizeof(members_); ++k) {
+      // unused slots repeat the first member, which keeps the loop free of branches.
+      m[k] = _mm_set1_epi8(static_cast<char>(members_[k < num_members_ ? k : 0]));
+    }
+    for (; i + 16 <= len; i += 16) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+      const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, m[0]), _mm_cmpeq_epi8(v, m[1])),
+                                       _mm_or_si128(_mm_cmpeq_epi8(v, m[2]), _mm_cmpeq_epi8(v, m[3])));
+      const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+      if (mask != 0) {
+        return i + CountTrailingZeros(mask);
+      }
+    }
+  }
+#elif defined(OCOS_BYTESET_NEON)
+  if (nibble_lookup_) {
+    const uint8x16_t low_table = vld1q_u8(low_nibbles_);
+    const uint8x16_t high_table = vld1q_u8(high_nibbles_);
+    const uint8x16_t nibble_mask = vdupq_n_u8(0x0F);
+    for (; i + 16 <= len; i += 16) {
+      const uint8x16_t v = vld1q_u8(p + i);
+      const uint8x16_t low = vqtbl1q_u8(low_table, vandq_u8(v, nibble_mask));
+      const uint8x16_t high = vqtbl1q_u8(high_table, vshrq_n_u8(v, 4));
+      if (vmaxvq_u8(vandq_u8(low, high)) != 0) {
+        break;
+      }
+    }
+  }
+#endif
+
+  for (; i < len; ++i) {
+    if (table_[p[i]]) {
+      return i;
+    }
+  }
+  return len;
+}
+
+}  // namespace ort_extensions
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ort_extensions {
+
+// A set of byte values, such as the separators of a split, with a vectorized search for its members.
+// With AVX2 or NEON any set whose members share at most 8 distinct high nibbles is matched 32 or 16 bytes at a
+// time through a nibble lookup table; SSE2 compares against up to 4 members directly. Other sets, and the tail of
+// the buffer, go through a 256-entry table.
+class ByteSet {
+ public:
+  explicit ByteSet(std::string_view members);
+
+  bool Contains(char c) const { return table_[static_cast<uint8_t>(c)]; }
+
+  // Returns the position of the first member in [data + from, data + len), or len if there is none.
+  size_t FindFirst(const char* data, size_t len, size_t from = 0) const noexcept;
+
+ private:
+  bool table_[256]{};
+  uint8_t members_[4]{};        // the first members, for the SSE2 comparisons
+  size_t num_members_{};        // distinct members
+  uint8_t low_nibbles_[16]{};   // bit g is set for the low nibbles of the members in high nibble group g
+  uint8_t high_nibbles_[16]{};  // bit g for the high nibble of group g, 0 for high nibbles without members
+  bool nibble_lookup_{};        // at most 8 distinct high nibbles
+};
+
+}  // namespace ort_extensions
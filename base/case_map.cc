@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "case_map.h"
+
+#include <array>
+#include <cstdint>
+
+#include "string_utils.h"
+#include "utf8.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OCOS_CASE_AVX2
+#define OCOS_CASE_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCOS_CASE_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCOS_CASE_NEON
+#endif
+
+namespace ort_extensions {
+namespace {
+
+// Flips the case of the bytes in [first, last] and copies the others, in whole blocks only.
+// With kStopAtNonAscii, stops at the first block that holds a non-ASCII byte and returns the bytes processed.
+template <char first, char last, bool kStopAtNonAscii>
+size_t FlipAsciiBlocks(const char* src, size_t len, char* dst) {
+  size_t i = 0;
+#if defined(OCOS_CASE_AVX2)
+  {
+    // bytes are compared as signed, so the non-ASCII ones are below `first`.
+    const __m256i lo = _mm256_set1_epi8(first - 1);
+    const __m256i hi = _mm256_set1_epi8(last + 1);
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    for (; i + 32 <= len; i += 32) {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      if (kStopAtNonAscii && _mm256_movemask_epi8(v) != 0) {
+        return i;
+      }
+      const __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_xor_si256(v, _mm256_and_si256(in_range, flip)));
+    }
+  }
+#endif
+#if defined(OCOS_CASE_SSE2)
+  const __m128i lo = _mm_set1_epi8(first - 1);
+  const __m128i hi = _mm_set1_epi8(last + 1);
+  const __m128i flip = _mm_set1_epi8(0x20);
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (kStopAtNonAscii && _mm_movemask_epi8(v) != 0) {
+      return i;
+    }
+    const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmpgt_epi8(hi, v));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(v, _mm_and_si128(in_range, flip)));
+  }
+#elif defined(OCOS_CASE_NEON)
+  const uint8x16_t lo = vdupq_n_u8(static_cast<uint8_t>(first));
+  const uint8x16_t hi = vdupq_n_u8(static_cast<uint8_t>(last));
+  const uint8x16_t flip = vdupq_n_u8(0x20);
+  for (; i + 16 <= len; i += 16) {
+    const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    if (kStopAtNonAscii && vmaxvq_u8(v) >= 0x80) {
+      return i;
+    }
+    const uint8x16_t in_range = vandq_u8(vcgeq_u8(v, lo), vcleq_u8(v, hi));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), veorq_u8(v, vandq_u8(in_range, flip)));
+  }
+#else
+  (void)src;
+  (void)len;
+  (void)dst;
+#endif
+  return i;
+}
+
+template <char first, char last>
+inline char FlipAscii(char c) {
+  return c >= first && c <= last ? static_cast<char>(c ^ 0x20) : c;
+}
+
+// ToLower of the code points with a 2-byte encoding, U+0080 to U+07FF, encoded back into 2 bytes.
+const std::array<uint16_t, 0x780>& LowerCaseTable2() {
+  static const std::array<uint16_t, 0x780> table = [] {
+    std::array<uint16_t, 0x780> t{};
+    for (char32_t c = 0x80; c < 0x800; ++c) {
+      char32_t lower = ToLower(c);
+      if (lower < 0x80 || lower >= 0x800) {
+        lower = c;
+      }
+      t[c - 0x80] = static_cast<uint16_t>(((0xC0 | (lower >> 6)) << 8) | (0x80 | (lower & 0x3F)));
+    }
+    return t;
+  }();
+  return table;
+}
+
+// Lowers the character at src[0] >= 0x80 into dst and returns its length, or 0 if it is malformed.
+size_t LowerCaseChar(const char* src, size_t len, char* dst) {
+  char32_t cp;
+  size_t n = DecodeUTF8Char(src, len, cp);
+  if (n == kInvalidUTF8) {
+    return 0;
+  }
+
+  if (n == 2) {
+    uint16_t encoded = LowerCaseTable2()[cp - 0x80];
+    dst[0] = static_cast<char>(encoded >> 8);
+    dst[1] = static_cast<char>(encoded & 0xFF);
+    return n;
+  }
+
+  char32_t lower = ToLower(cp);
+  char encoded[4];
+  if (lower != cp && ConvertUTF32ToUTF8(&lower, 1, encoded) == n) {
+    for (size_t k = 0; k < n; ++k) {
+      dst[k] = encoded[k];
+    }
+  } else {
+    for (size_t k = 0; k < n; ++k) {
+      dst[k] = src[k];
+    }
+  }
+  return n;
+}
+
+}  // namespace
+
+bool LowerCaseUTF8(const char* src, size_t len, char* dst) noexcept {
+  size_t i = 0;
+  while (i < len) {
+    i += FlipAsciiBlocks<'A', 'Z', true>(src + i, len - i, dst + i);
+    // convert up to the next block boundary one character at a time, then try the vector path again.
+    const size_t block_end = i + 16 < len ? i + 16 : len;
+    while (i < block_end) {
+      if (static_cast<unsigned char>(src[i]) < 0x80) {
+        dst[i] = FlipAscii<'A', 'Z'>(src[i]);
+        ++i;
+        continue;
+      }
+      size_t n = LowerCaseChar(src + i, len - i, dst + i);
+      if (n == 0) {
+        return false;
+      }
+      i += n;
+    }
+  }
+  return true;
+}
+
+void UpperCaseAscii(const char* src, size_t len, char* dst) noexcept {
+  size_t i = FlipAsciiBlocks<'a', 'z', false>(src, len, dst);
+  for (; i < len; ++i) {
+    dst[i] = FlipAscii<'a', 'z'>(src[i]);
+  }
+}
+
+}  // namespace ort_extensions
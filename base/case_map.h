@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+
+// Case mapping of UTF-8 text for the StringLower and StringUpper kernels.
+// ASCII runs are converted in 16-byte (SSE2/NEON) or 32-byte (AVX2) blocks; only the non-ASCII characters are
+// decoded. The output always has the length of the input, so dst may be src, or a slot of a preallocated buffer.
+namespace ort_extensions {
+
+// Maps every character of [src, src + len) through ToLower into dst. The 2-byte sequences go through a table
+// built from ToLower; a mapping that would change the encoded length is not applied.
+// Returns false if the input is not well-formed UTF-8, in which case dst holds a partial result.
+bool LowerCaseUTF8(const char* src, size_t len, char* dst) noexcept;
+
+// Upper-cases the ASCII letters of [src, src + len) into dst and copies all the other bytes unchanged.
+void UpperCaseAscii(const char* src, size_t len, char* dst) noexcept;
+
+}  // namespace ort_extensions
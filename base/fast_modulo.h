@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace ort_extensions {
+
+// Remainder of the division by a divisor fixed ahead of a loop, without a 64-bit division per element.
+// Uses the direct computation of Lemire, Kaser and Kurz ("Faster remainder by direct computation", 2019):
+// with M = ceil(2^128 / d), the remainder a % d is the high 64 bits of the low 128 bits of M * a, times d.
+// The result is exact for every 64-bit value and divisor; the compilers without a 128-bit integer type use %.
+class FastModulo {
+ public:
+  // divisor must not be zero.
+  explicit FastModulo(uint64_t divisor) : divisor_(divisor) {
+#if defined(__SIZEOF_INT128__)
+    // wraps to 0 for a divisor of 1, for which every remainder is 0 as well.
+    multiplier_ = ~static_cast<unsigned __int128>(0) / divisor + 1;
+#endif
+  }
+
+  uint64_t divisor() const { return divisor_; }
+
+  uint64_t operator()(uint64_t value) const {
+#if defined(__SIZEOF_INT128__)
+    using uint128 = unsigned __int128;
+    const uint128 low_bits = multiplier_ * value;
+    const uint128 bottom = (static_cast<uint128>(static_cast<uint64_t>(low_bits)) * divisor_) >> 64;
+    const uint128 top = static_cast<uint128>(static_cast<uint64_t>(low_bits >> 64)) * divisor_;
+    return static_cast<uint64_t>((bottom + top) >> 64);
+#else
+    return value % divisor_;
+#endif
+  }
+
+ private:
+  uint64_t divisor_;
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 multiplier_;
+#endif
+};
+
+}  // namespace ort_extensions
@@ -0,0 +1,377 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OCOS_FFT_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCOS_FFT_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCOS_FFT_NEON
+#endif
+
+namespace ort_extensions {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+// A vector of kLanes complex numbers, interleaved like the data, with the complex operations of the butterflies.
+#if defined(OCOS_FFT_AVX2)
+using Packet = __m256;
+constexpr size_t kLanes = 4;
+inline Packet Load(const void* p) { return _mm256_loadu_ps(static_cast<const float*>(p)); }
+inline void Store(void* p, Packet v) { _mm256_storeu_ps(static_cast<float*>(p), v); }
+inline Packet Add(Packet a, Packet b) { return _mm256_add_ps(a, b); }
+inline Packet Sub(Packet a, Packet b) { return _mm256_sub_ps(a, b); }
+inline Packet Multiply(Packet a, Packet b) {
+  const Packet swapped = _mm256_permute_ps(a, 0xB1);
+  return _mm256_addsub_ps(_mm256_mul_ps(a, _mm256_moveldup_ps(b)), _mm256_mul_ps(swapped, _mm256_movehdup_ps(b)));
+}
+// -i * a = (a.im, -a.re)
+inline Packet MultiplyNegI(Packet a) {
+  const Packet sign = _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+  return _mm256_xor_ps(_mm256_permute_ps(a, 0xB1), sign);
+}
+#elif defined(OCOS_FFT_SSE2)
+using Packet = __m128;
+constexpr size_t kLanes = 2;
+inline Packet Load(const void* p) { return _mm_loadu_ps(static_cast<const float*>(p)); }
+inline void Store(void* p, Packet v) { _mm_storeu_ps(static_cast<float*>(p), v); }
+inline Packet Add(Packet a, Packet b) { return _mm_add_ps(a, b); }
+inline Packet Sub(Packet a, Packet b) { return _mm_sub_ps(a, b); }
+inline Packet Multiply(Packet a, Packet b) {
+  const Packet sign = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+  const Packet b_re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+  const Packet b_im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+  const Packet swapped = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_add_ps(_mm_mul_ps(a, b_re), _mm_xor_ps(_mm_mul_ps(swapped, b_im), sign));
+}
+inline Packet MultiplyNegI(Packet a) {
+  const Packet sign = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+  return _mm_xor_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), sign);
+}
+#elif defined(OCOS_FFT_NEON)
+using Packet = float32x4_t;
+constexpr size_t kLanes = 2;
+inline Packet Load(const void* p) { return vld1q_f32(static_cast<const float*>(p)); }
+inline void Store(void* p, Packet v) { vst1q_f32(static_cast<float*>(p), v); }
+inline Packet Add(Packet a, Packet b) { return vaddq_f32(a, b); }
+inline Packet Sub(Packet a, Packet b) { return vsubq_f32(a, b); }
+inline Packet Multiply(Packet a, Packet b) {
+  const float sign_values[4] = {-1.0f, 1.0f, -1.0f, 1.0f};
+  const Packet cross = vmulq_f32(vrev64q_f32(a), vtrn2q_f32(b, b));
+  return vmlaq_f32(vmulq_f32(a, vtrn1q_f32(b, b)), cross, vld1q_f32(sign_values));
+}
+inline Packet MultiplyNegI(Packet a) {
+  const float sign_values[4] = {1.0f, -1.0f, 1.0f, -1.0f};
+  return vmulq_f32(vrev64q_f32(a), vld1q_f32(sign_values));
+}
+#endif
+
+}  // namespace
+
+RealFFT::RealFFT(size_t n) : n_(n), m_(n % 2 == 0 ? n / 2 : n) {
+  // the stages split the length by 4 first, the butterfly with the fewest multiplications per output.
+  size_t remaining = m_;
+  size_t radix = 4;
+  while (remaining > 1) {
+    while (remaining % radix != 0) {
+      radix = radix == 4 ? 2 : radix == 2 ? 3 : radix + 2;
+      if (radix * radix > remaining) {
+        radix = remaining;
+      }
+    }
+    remaining /= radix;
+    stages_.push_back({radix, remaining, stage_twiddles_.size()});
+    max_radix_ = std::max(max_radix_, radix);
+
+    // the butterfly k of the stage multiplies its input r by exp(-2 pi i r k / (radix * span)).
+    const double length = static_cast<double>(radix * remaining);
+    for (size_t r = 1; r < radix; ++r) {
+      for (size_t k = 0; k < remaining; ++k) {
+        const double phase = -kTwoPi * static_cast<double>(r * k) / length;
+        stage_twiddles_.push_back({static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))});
+      }
+    }
+  }
+
+  twiddles_.resize(m_);
+  for (size_t k = 0; k < m_; ++k) {
+    const double phase = -kTwoPi * static_cast<double>(k) / static_cast<double>(m_);
+    twiddles_[k] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+  }
+
+  if (n_ % 2 == 0) {
+    split_twiddles_.resize(m_ / 2 + 1);
+    for (size_t k = 0; k <= m_ / 2; ++k) {
+      const double phase = -kTwoPi * static_cast<double>(k) / static_cast<double>(n_);
+      split_twiddles_[k] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+    }
+  }
+}
+
+std::shared_ptr<const RealFFT> RealFFT::Get(size_t n) {
+  static std::mutex mutex;
+  static std::map<size_t, std::shared_ptr<const RealFFT>> plans;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& plan = plans[n];
+  if (!plan) {
+    plan = std::make_shared<const RealFFT>(n);
+  }
+  return plan;
+}
+
+size_t RealFFT::ScratchSize() const {
+  // an odd length needs its complex input and output, the generic butterfly one radix of values.
+  return 2 * max_radix_ + (n_ % 2 == 0 ? 0 : 4 * n_);
+}
+
+void RealFFT::Forward(const float* input, float* output, float* scratch) const {
+  auto* bins = reinterpret_cast<Complex*>(output);
+  auto* work = reinterpret_cast<Complex*>(scratch);
+
+  if (n_ % 2 != 0) {
+    Complex* samples = work + max_radix_;
+    Complex* spectrum = samples + n_;
+    for (size_t i = 0; i < n_; ++i) {
+      samples[i] = {input[i], 0.0f};
+    }
+    Transform(samples, 1, 0, spectrum, work);
+    std::copy(spectrum, spectrum + NumBins(), bins);
+    return;
+  }
+
+  // Z = FFT(x[2k] + i x[2k + 1]) has the DFTs of the even and odd samples, E[k] = (Z[k] + conj(Z[m - k])) / 2 and
+  // O[k] = (Z[k] - conj(Z[m - k])) / 2i, which combine into X[k] = E[k] + W^k O[k] and X[m - k] = conj(E[k] - W^k O[k]).
+  Transform(reinterpret_cast<const Complex*>(input), 1, 0, bins, work);
+  const Complex z0 = bins[0];
+  bins[0] = {z0.re + z0.im, 0.0f};
+  bins[m_] = {z0.re - z0.im, 0.0f};
+  for (size_t k = 1; k <= m_ / 2; ++k) {
+    const Complex a = bins[k];
+    const Complex b = {bins[m_ - k].re, -bins[m_ - k].im};
+    const Complex even = {0.5f * (a.re + b.re), 0.5f * (a.im + b.im)};
+    const Complex odd = {0.5f * (a.im - b.im), -0.5f * (a.re - b.re)};
+    const Complex w_odd = Multiply(split_twiddles_[k], odd);
+    bins[k] = {even.re + w_odd.re, even.im + w_odd.im};
+    bins[m_ - k] = {even.re - w_odd.re, w_odd.im - even.im};
+  }
+}
+
+void RealFFT::Transform(const Complex* input, size_t stride, size_t stage, Complex* output, Complex* scratch) const {
+  if (stage == stages_.size()) {
+    output[0] = input[0];
+    return;
+  }
+
+  // the radix sub-transforms of the samples congruent modulo radix, then the butterflies that combine them.
+  const Stage& s = stages_[stage];
+  if (s.span == 1) {
+    for (size_t j = 0; j < s.radix; ++j) {
+      output[j] = input[j * stride];
+    }
+  } else {
+    for (size_t j = 0; j < s.radix; ++j) {
+      Transform(input + j * stride, stride * s.radix, stage + 1, output + j * s.span, scratch);
+    }
+  }
+
+  const Complex* twiddles = stage_twiddles_.data() + s.twiddle_offset;
+  switch (s.radix) {
+    case 2:
+      Butterfly2(output, twiddles, s.span);
+      break;
+    case 3:
+      Butterfly3(output, twiddles, s.span);
+      break;
+    case 4:
+      Butterfly4(output, twiddles, s.span);
+      break;
+    case 5:
+      Butterfly5(output, twiddles, s.span);
+      break;
+    default:
+      ButterflyGeneric(output, stride, s.radix, s.span, scratch);
+      break;
+  }
+}
+
+void RealFFT::Butterfly2(Complex* data, const Complex* twiddles, size_t span) {
+  Complex* a = data;
+  Complex* b = data + span;
+  size_t k = 0;
+#if defined(OCOS_FFT_AVX2) || defined(OCOS_FFT_SSE2) || defined(OCOS_FFT_NEON)
+  for (; k + kLanes <= span; k += kLanes) {
+    const Packet a0 = Load(a + k);
+    const Packet t = ort_extensions::Multiply(Load(b + k), Load(twiddles + k));
+    Store(a + k, Add(a0, t));
+    Store(b + k, Sub(a0, t));
+  }
+#endif
+  for (; k < span; ++k) {
+    const Complex t = Multiply(b[k], twiddles[k]);
+    b[k] = {a[k].re - t.re, a[k].im - t.im};
+    a[k] = {a[k].re + t.re, a[k].im + t.im};
+  }
+}
+
+void RealFFT::Butterfly3(Complex* data, const Complex* twiddles, size_t span) {
+  // sin(2 pi / 3) with the sign of the forward transform.
+  const float sine = -0.86602540378443864676f;
+  for (size_t k = 0; k < span; ++k) {
+    const Complex a0 = data[k];
+    const Complex a1 = Multiply(data[k + span], twiddles[k]);
+    const Complex a2 = Multiply(data[k + 2 * span], twiddles[span + k]);
+    const Complex sum = {a1.re + a2.re, a1.im + a2.im};
+    const Complex base = {a0.re - 0.5f * sum.re, a0.im - 0.5f * sum.im};
+    const Complex diff = {sine * (a1.re - a2.re), sine * (a1.im - a2.im)};
+    data[k] = {a0.re + sum.re, a0.im + sum.im};
+    data[k + span] = {base.re - diff.im, base.im + diff.re};
+    data[k + 2 * span] = {base.re + diff.im, base.im - diff.re};
+  }
+}
+
+void RealFFT::Butterfly4(Complex* data, const Complex* twiddles, size_t span) {
+  // X0 = s02 + s13, X1 = d02 - i d13, X2 = s02 - s13 and X3 = d02 + i d13.
+  Complex* x0 = data;
+  Complex* x1 = data + span;
+  Complex* x2 = data + 2 * span;
+  Complex* x3 = data + 3 * span;
+  const Complex* w1 = twiddles;
+  const Complex* w2 = twiddles + span;
+  const Complex* w3 = twiddles + 2 * span;
+  size_t k = 0;
+#if defined(OCOS_FFT_AVX2) || defined(OCOS_FFT_SSE2) || defined(OCOS_FFT_NEON)
+  for (; k + kLanes <= span; k += kLanes) {
+    const Packet a0 = Load(x0 + k);
+    const Packet a1 = ort_extensions::Multiply(Load(x1 + k), Load(w1 + k));
+    const Packet a2 = ort_extensions::Multiply(Load(x2 + k), Load(w2 + k));
+    const Packet a3 = ort_extensions::Multiply(Load(x3 + k), Load(w3 + k));
+    const Packet s02 = Add(a0, a2);
+    const Packet d02 = Sub(a0, a2);
+    const Packet s13 = Add(a1, a3);
+    const Packet d13 = MultiplyNegI(Sub(a1, a3));
+    Store(x0 + k, Add(s02, s13));
+    Store(x1 + k, Add(d02, d13));
+    Store(x2 + k, Sub(s02, s13));
+    Store(x3 + k, Sub(d02, d13));
+  }
+#endif
+  for (; k < span; ++k) {
+    const Complex a0 = x0[k];
+    const Complex a1 = Multiply(x1[k], w1[k]);
+    const Complex a2 = Multiply(x2[k], w2[k]);
+    const Complex a3 = Multiply(x3[k], w3[k]);
+    const Complex s02 = {a0.re + a2.re, a0.im + a2.im};
+    const Complex d02 = {a0.re - a2.re, a0.im - a2.im};
+    const Complex s13 = {a1.re + a3.re, a1.im + a3.im};
+    const Complex d13 = {a1.re - a3.re, a1.im - a3.im};
+    x0[k] = {s02.re + s13.re, s02.im + s13.im};
+    x1[k] = {d02.re + d13.im, d02.im - d13.re};
+    x2[k] = {s02.re - s13.re, s02.im - s13.im};
+    x3[k] = {d02.re - d13.im, d02.im + d13.re};
+  }
+}
+
+void RealFFT::Butterfly5(Complex* data, const Complex* twiddles, size_t span) {
+  // w = exp(-2 pi i / 5) and w^2; the outputs pair up as conjugates around the sums of a1 + a4 and a2 + a3.
+  const Complex w1 = {0.30901699437494742410f, -0.95105651629515357212f};
+  const Complex w2 = {-0.80901699437494742410f, -0.58778525229247312917f};
+  for (size_t k = 0; k < span; ++k) {
+    const Complex a0 = data[k];
+    const Complex a1 = Multiply(data[k + span], twiddles[k]);
+    const Complex a2 = Multiply(data[k + 2 * span], twiddles[span + k]);
+    const Complex a3 = Multiply(data[k + 3 * span], twiddles[2 * span + k]);
+    const Complex a4 = Multiply(data[k + 4 * span], twiddles[3 * span + k]);
+    const Complex s14 = {a1.re + a4.re, a1.im + a4.im};
+    const Complex d14 = {a1.re - a4.re, a1.im - a4.im};
+    const Complex s23 = {a2.re + a3.re, a2.im + a3.im};
+    const Complex d23 = {a2.re - a3.re, a2.im - a3.im};
+
+    const Complex c1 = {a0.re + w1.re * s14.re + w2.re * s23.re, a0.im + w1.re * s14.im + w2.re * s23.im};
+    const Complex c2 = {a0.re + w2.re * s14.re + w1.re * s23.re, a0.im + w2.re * s14.im + w1.re * s23.im};
+    // i times the odd parts, with sin(2 pi / 5) = -w1.im and sin(4 pi / 5) = -w2.im.
+    const Complex t1 = {w1.im * d14.re + w2.im * d23.re, w1.im * d14.im + w2.im * d23.im};
+    const Complex t2 = {w2.im * d14.re - w1.im * d23.re, w2.im * d14.im - w1.im * d23.im};
+
+    data[k] = {a0.re + s14.re + s23.re, a0.im + s14.im + s23.im};
+    data[k + span] = {c1.re - t1.im, c1.im + t1.re};
+    data[k + 4 * span] = {c1.re + t1.im, c1.im - t1.re};
+    data[k + 2 * span] = {c2.re - t2.im, c2.im + t2.re};
+    data[k + 3 * span] = {c2.re + t2.im, c2.im - t2.re};
+  }
+}
+
+void RealFFT::ButterflyGeneric(Complex* data, size_t stride, size_t radix, size_t span, Complex* scratch) const {
+  for (size_t u = 0; u < span; ++u) {
+    for (size_t q = 0; q < radix; ++q) {
+      scratch[q] = data[u + q * span];
+    }
+
+    for (size_t q = 0; q < radix; ++q) {
+      const size_t k = u + q * span;
+      Complex sum = scratch[0];
+      size_t index = 0;
+      for (size_t r = 1; r < radix; ++r) {
+        // index = r * k * stride modulo m; k * stride < m.
+        index += k * stride;
+        if (index >= m_) {
+          index -= m_;
+        }
+        const Complex t = Multiply(scratch[r], twiddles_[index]);
+        sum.re += t.re;
+        sum.im += t.im;
+      }
+      data[k] = sum;
+    }
+  }
+}
+
+FramePowerSpectrum::FramePowerSpectrum(std::vector<float> window)
+    : fft_(RealFFT::Get(window.size())), window_(std::move(window)) {
+}
+
+FramePowerSpectrum::Workspace FramePowerSpectrum::MakeWorkspace() const {
+  Workspace workspace;
+  workspace.frame.resize(window_.size());
+  workspace.spectrum.resize(2 * fft_->NumBins());
+  workspace.scratch.resize(fft_->ScratchSize());
+  return workspace;
+}
+
+void FramePowerSpectrum::Compute(const float* signal, int64_t length, int64_t center, float* power,
+                                 Workspace& workspace) const {
+  const size_t n_fft = window_.size();
+  const int64_t start = center - static_cast<int64_t>(n_fft / 2);
+  float* frame = workspace.frame.data();
+  if (start >= 0 && start + static_cast<int64_t>(n_fft) <= length) {
+    for (size_t k = 0; k < n_fft; ++k) {
+      frame[k] = signal[start + static_cast<int64_t>(k)] * window_[k];
+    }
+  } else {
+    for (size_t k = 0; k < n_fft; ++k) {
+      int64_t t = start + static_cast<int64_t>(k);
+      t = t < 0 ? -t : t >= length ? 2 * (length - 1) - t : t;
+      frame[k] = signal[t] * window_[k];
+    }
+  }
+
+  const float* spectrum = workspace.spectrum.data();
+  fft_->Forward(frame, workspace.spectrum.data(), workspace.scratch.data());
+  for (size_t k = 0; k < fft_->NumBins(); ++k) {
+    power[k] = spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1];
+  }
+}
+
+}  // namespace ort_extensions
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ort_extensions {
+
+// Forward DFT of real signals of a fixed length n, for any n > 0.
+// An even n is transformed as n / 2 complex samples (the even and odd samples as the real and imaginary parts)
+// followed by a split step, an odd one as n complex samples with a zero imaginary part. The complex FFT is a
+// mixed-radix decimation in time: the radix-4 and radix-2 butterflies run on AVX2, SSE2 or NEON vectors, the radix-3
+// and radix-5 ones are scalar and the other prime factors go through a generic O(radix^2) butterfly.
+// The twiddle factors of every stage are computed once per length, in the order the butterflies read them;
+// Get shares the plans between the kernels.
+class RealFFT {
+ public:
+  explicit RealFFT(size_t n);
+
+  // The plan for the length n, built on the first call and cached for the process.
+  static std::shared_ptr<const RealFFT> Get(size_t n);
+
+  size_t size() const { return n_; }
+
+  // Number of the bins of the one-sided spectrum, n / 2 + 1.
+  size_t NumBins() const { return n_ / 2 + 1; }
+
+  // Number of the floats of the scratch buffer that Forward needs.
+  size_t ScratchSize() const;
+
+  // Writes the bins [0, n / 2] of the DFT of input[0, n) to output as NumBins() interleaved (real, imaginary) pairs.
+  // Thread-safe: the state of a call is in output and scratch.
+  void Forward(const float* input, float* output, float* scratch) const;
+
+ private:
+  struct Complex {
+    float re;
+    float im;
+  };
+
+  // the radix of a stage, the length of the sub-transforms it combines, and where its twiddle factors start: the
+  // factor of the input r of the butterfly k is stage_twiddles_[twiddle_offset + (r - 1) * span + k].
+  struct Stage {
+    size_t radix;
+    size_t span;
+    size_t twiddle_offset;
+  };
+
+  static Complex Multiply(Complex a, Complex b) {
+    return {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+  }
+
+  void Transform(const Complex* input, size_t stride, size_t stage, Complex* output, Complex* scratch) const;
+  static void Butterfly2(Complex* data, const Complex* twiddles, size_t span);
+  static void Butterfly3(Complex* data, const Complex* twiddles, size_t span);
+  static void Butterfly4(Complex* data, const Complex* twiddles, size_t span);
+  static void Butterfly5(Complex* data, const Complex* twiddles, size_t span);
+  void ButterflyGeneric(Complex* data, size_t stride, size_t radix, size_t span, Complex* scratch) const;
+
+  size_t n_;
+  // the length of the complex transform, n / 2 for an even n, n otherwise.
+  size_t m_;
+  size_t max_radix_{};
+  std::vector<Stage> stages_;
+  std::vector<Complex> stage_twiddles_;
+  // exp(-2 pi i k / m) for k in [0, m), read with a stride by the generic butterfly.
+  std::vector<Complex> twiddles_;
+  // exp(-2 pi i k / n) for k in [0, m / 2], the split step of an even n.
+  std::vector<Complex> split_twiddles_;
+};
+
+// Squared magnitudes of the one-sided DFT of windowed frames of a signal, the frames of torch.stft with center=True
+// and pad_mode="reflect": n_fft samples centered on a sample of the signal, which is reflected at its ends.
+class FramePowerSpectrum {
+ public:
+  // window has n_fft > 0 samples.
+  explicit FramePowerSpectrum(std::vector<float> window);
+
+  size_t NumBins() const { return fft_->NumBins(); }
+
+  // The buffers of one thread.
+  struct Workspace {
+    std::vector<float> frame;
+    std::vector<float> spectrum;
+    std::vector<float> scratch;
+  };
+  Workspace MakeWorkspace() const;
+
+  // Writes the NumBins() energies of the frame centered on signal[center] to power.
+  // The signal must be longer than n_fft / 2 samples.
+  void Compute(const float* signal, int64_t length, int64_t center, float* power, Workspace& workspace) const;
+
+ private:
+  std::shared_ptr<const RealFFT> fft_;
+  std::vector<float> window_;
+};
+
+}  // namespace ort_extensions
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace ort_extensions {
+namespace {
+
+// a displacement with this bit set holds the slot of a single-key bucket directly.
+constexpr uint32_t kDirectSlot = 0x80000000u;
+// keys per bucket on average; larger buckets make the table smaller but slower to build.
+constexpr size_t kBucketLoad = 4;
+// displacements tried for a bucket before starting over with another seed.
+constexpr uint32_t kMaxDisplacement = 1u << 20;
+
+inline uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+uint64_t HashBytes(std::string_view key, uint64_t seed) {
+  constexpr uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+  uint64_t h = seed ^ (key.size() * kMul);
+  size_t i = 0;
+  for (; i + 8 <= key.size(); i += 8) {
+    uint64_t word;
+    std::memcpy(&word, key.data() + i, 8);
+    h = (h ^ Mix(word)) * kMul;
+  }
+  if (i < key.size()) {
+    uint64_t word = 0;
+    std::memcpy(&word, key.data() + i, key.size() - i);
+    h = (h ^ Mix(word)) * kMul;
+  }
+  return Mix(h);
+}
+
+inline size_t BucketOf(uint64_t hash, size_t num_buckets) {
+  return static_cast<size_t>((hash >> 32) % num_buckets);
+}
+
+inline size_t DisplacedSlot(uint64_t hash, uint32_t displacement, size_t num_slots) {
+  return static_cast<size_t>(Mix(hash ^ (displacement * 0x9e3779b97f4a7c15ULL)) % num_slots);
+}
+
+}  // namespace
+
+PerfectHashTable::PerfectHashTable(const std::vector<std::string_view>& keys) {
+  std::unordered_map<std::string_view, size_t> last_position;
+  last_position.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    last_position[keys[i]] = i;
+  }
+  std::vector<size_t> distinct;
+  distinct.reserve(last_position.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (last_position[keys[i]] == i) {
+      distinct.push_back(i);
+    }
+  }
+
+  const size_t n = distinct.size();
+  if (n == 0) {
+    return;
+  }
+  const size_t num_buckets = (n + kBucketLoad - 1) / kBucketLoad;
+  std::vector<uint64_t> hashes(n);
+  std::vector<size_t> slot_ids(n);
+  std::vector<bool> taken(n);
+  std::vector<std::vector<size_t>> buckets(num_buckets);
+  std::vector<size_t> slots;
+
+  for (uint64_t attempt = 0;; ++attempt) {
+    seed_ = Mix(attempt + 1);
+    for (auto& bucket : buckets) {
+      bucket.clear();
+    }
+    for (size_t k = 0; k < n; ++k) {
+      hashes[k] = HashBytes(keys[distinct[k]], seed_);
+      buckets[BucketOf(hashes[k], num_buckets)].push_back(k);
+    }
+    std::vector<size_t> order(num_buckets);
+    for (size_t b = 0; b < num_buckets; ++b) {
+      order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    displacements_.assign(num_buckets, 0);
+    std::fill(taken.begin(), taken.end(), false);
+    size_t next_free = 0;
+    bool placed = true;
+    for (size_t b : order) {
+      const auto& bucket = buckets[b];
+      if (bucket.empty()) {
+        break;
+      }
+      if (bucket.size() == 1) {
+        // the largest buckets are placed first, so the single keys fill the remaining slots in order.
+        while (taken[next_free]) {
+          ++next_free;
+        }
+        taken[next_free] = true;
+        slot_ids[next_free] = bucket[0];
+        displacements_[b] = kDirectSlot | static_cast<uint32_t>(next_free);
+        continue;
+      }
+
+      placed = false;
+      for (uint32_t d = 0; d < kMaxDisplacement && !placed; ++d) {
+        slots.clear();
+        for (size_t k : bucket) {
+          size_t slot = DisplacedSlot(hashes[k], d, n);
+          if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+            break;
+          }
+          slots.push_back(slot);
+        }
+        if (slots.size() == bucket.size()) {
+          for (size_t j = 0; j < slots.size(); ++j) {
+            taken[slots[j]] = true;
+            slot_ids[slots[j]] = bucket[j];
+          }
+          displacements_[b] = d;
+          placed = true;
+        }
+      }
+      if (!placed) {
+        break;
+      }
+    }
+    if (placed) {
+      break;
+    }
+  }
+
+  ids_.resize(n);
+  for (size_t slot = 0; slot < n; ++slot) {
+    ids_[slot] = distinct[slot_ids[slot]];
+    keys_.Append(keys[ids_[slot]]);
+  }
+}
+
+size_t PerfectHashTable::SlotOf(uint64_t hash) const {
+  uint32_t displacement = displacements_[BucketOf(hash, displacements_.size())];
+  if (displacement & kDirectSlot) {
+    return displacement & ~kDirectSlot;
+  }
+  return DisplacedSlot(hash, displacement, ids_.size());
+}
+
+size_t PerfectHashTable::Find(std::string_view key) const {
+  if (ids_.empty()) {
+    return kNotFound;
+  }
+  size_t slot = SlotOf(HashBytes(key, seed_));
+  return keys_[slot] == key ? ids_[slot] : kNotFound;
+}
+
+}  // namespace ort_extensions
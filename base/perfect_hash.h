@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ort_extensions {
+
+// A list of strings stored back to back in one buffer.
+class StringBlob {
+ public:
+  void Append(std::string_view str) {
+    if (offsets_.empty()) {
+      offsets_.push_back(0);
+    }
+    data_.append(str.data(), str.size());
+    offsets_.push_back(data_.size());
+  }
+
+  size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+  std::string_view operator[](size_t i) const {
+    return std::string_view(data_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+  }
+
+ private:
+  std::string data_;
+  std::vector<size_t> offsets_;
+};
+
+// An immutable map from byte-string keys to their positions in the list the table is built from.
+// The keys are placed with a minimal perfect hash (hash and displace): a lookup hashes the probe once, reads the
+// displacement of its bucket and compares the probe with the single key stored in the resulting slot. The keys
+// live in one buffer in slot order, and lookups take a std::string_view without allocating.
+// Built once when a model is attached, then safe to read from any number of threads.
+class PerfectHashTable {
+ public:
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  PerfectHashTable() = default;
+
+  // A key listed several times maps to its last position, as with repeated assignments into a map.
+  explicit PerfectHashTable(const std::vector<std::string_view>& keys);
+
+  // Number of distinct keys.
+  size_t size() const { return ids_.size(); }
+
+  // Returns the position of the key in the list given to the constructor, or kNotFound.
+  size_t Find(std::string_view key) const;
+
+ private:
+  size_t SlotOf(uint64_t hash) const;
+
+  uint64_t seed_{};
+  std::vector<uint32_t> displacements_;  // one per bucket
+  std::vector<size_t> ids_;              // one per slot
+  StringBlob keys_;                      // one per slot
+};
+
+}  // namespace ort_extensions
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+namespace ort_extensions {
+
+namespace {
+thread_local bool tls_in_parallel_loop = false;
+
+size_t DefaultThreadCount() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  return 1;
+#else
+  if (const char* env = std::getenv("ORTX_NUM_THREADS")) {
+    long value = std::strtol(env, nullptr, 10);
+    if (value > 0) {
+      return static_cast<size_t>(value);
+    }
+  }
+  size_t hw = std::thread::hardware_concurrency();
+  return hw == 0 ? 1 : hw;
+#endif
+}
+}  // namespace
+
+struct ThreadPool::Job {
+  const RangeFn* fn;
+  size_t n;
+  size_t grain;
+  size_t num_chunks;
+  std::atomic<size_t> next_chunk{};
+  std::atomic<size_t> done_chunks{};
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+#ifndef OCOS_NO_EXCEPTIONS
+  std::atomic<bool> failed{};
+  std::exception_ptr error;  // the first exception of a chunk, guarded by done_mutex
+#endif
+};
+
+ThreadPool::ThreadPool(size_t num_threads) {
+  for (size_t i = 1; i < num_threads; ++i) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+ThreadPool& ThreadPool::Global() {
+  // intentionally leaked: joining threads from static destructors may deadlock when the library is unloaded.
+  static ThreadPool* pool = new ThreadPool(DefaultThreadCount());
+  return *pool;
+}
+
+void ThreadPool::RunChunks(Job& job) {
+  bool was_in_loop = tls_in_parallel_loop;
+  tls_in_parallel_loop = true;
+  for (;;) {
+    size_t chunk = job.next_chunk.fetch_add(1);
+    if (chunk >= job.num_chunks) {
+      break;
+    }
+    size_t begin = chunk * job.grain;
+#ifndef OCOS_NO_EXCEPTIONS
+    // after an exception the chunks left are only counted, so that the loop still joins.
+    if (!job.failed.load()) {
+      try {
+        (*job.fn)(begin, std::min(job.n, begin + job.grain));
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(job.done_mutex);
+        if (!job.error) {
+          job.error = std::current_exception();
+        }
+        job.failed.store(true);
+      }
+    }
+#else
+    (*job.fn)(begin, std::min(job.n, begin + job.grain));
+#endif
+    if (job.done_chunks.fetch_add(1) + 1 == job.num_chunks) {
+      std::lock_guard<std::mutex> lock(job.done_mutex);
+      job.done_cv.notify_all();
+    }
+  }
+  tls_in_parallel_loop = was_in_loop;
+}
+
+void ThreadPool::WorkerLoop() {
+  uint64_t seen = 0;
+  for (;;) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_cv_.wait(lock, [&] { return stop_ || (job_ && generation_ != seen); });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      job = job_;
+    }
+    RunChunks(*job);
+  }
+}
+
+void ThreadPool::ParallelFor(size_t n, size_t min_grain, const RangeFn& fn) {
+  if (n == 0) {
+    return;
+  }
+
+  min_grain = std::max<size_t>(min_grain, 1);
+  // a few chunks per thread balance uneven rows without making the chunks too small.
+  size_t grain = std::max(min_grain, (n + NumThreads() * 4 - 1) / (NumThreads() * 4));
+  if (workers_.empty() || n <= grain || tls_in_parallel_loop) {
+    fn(0, n);
+    return;
+  }
+
+  std::unique_lock<std::mutex> submit(submit_mutex_, std::try_to_lock);
+  if (!submit.owns_lock()) {
+    fn(0, n);
+    return;
+  }
+
+  auto job = std::make_shared<Job>();
+  job->fn = &fn;
+  job->n = n;
+  job->grain = grain;
+  job->num_chunks = (n + grain - 1) / grain;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = job;
+    ++generation_;
+  }
+  work_cv_.notify_all();
+
+  RunChunks(*job);
+  {
+    std::unique_lock<std::mutex> lock(job->done_mutex);
+    job->done_cv.wait(lock, [&] { return job->done_chunks.load() == job->num_chunks; });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_.reset();
+  }
+
+#ifndef OCOS_NO_EXCEPTIONS
+  if (job->error) {
+    std::rethrow_exception(job->error);
+  }
+#endif
+}
+
+}  // namespace ort_extensions
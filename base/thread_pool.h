@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ort_extensions {
+
+// A small fork-join pool for data-parallel loops inside a kernel's Compute.
+// The calling thread takes part in the work. The pool runs one loop at a time: a loop submitted while another one
+// is running, or from inside a worker, runs serially on the calling thread, so kernels executed concurrently by ORT
+// never oversubscribe the machine or deadlock on each other.
+// Kernels report per-row errors through their own status values. An exception thrown by the loop body skips the
+// chunks not started yet, and ParallelFor rethrows it once the running ones have finished.
+class ThreadPool {
+ public:
+  using RangeFn = std::function<void(size_t begin, size_t end)>;
+
+  explicit ThreadPool(size_t num_threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Process-wide pool, sized by the ORTX_NUM_THREADS environment variable or the hardware concurrency.
+  static ThreadPool& Global();
+
+  // Number of threads a loop can run on, including the calling one.
+  size_t NumThreads() const { return workers_.size() + 1; }
+
+  // Calls fn on consecutive sub-ranges of [0, n) that cover it exactly once; each sub-range holds at least
+  // min_grain items, except possibly the last one.
+  void ParallelFor(size_t n, size_t min_grain, const RangeFn& fn);
+
+ private:
+  struct Job;
+  void WorkerLoop();
+  static void RunChunks(Job& job);
+
+  std::vector<std::thread> workers_;
+  std::mutex submit_mutex_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::shared_ptr<Job> job_;
+  uint64_t generation_{};
+  bool stop_{};
+};
+
+// Shorthand for ThreadPool::Global().ParallelFor(n, min_grain, fn).
+inline void ParallelFor(size_t n, size_t min_grain, const ThreadPool::RangeFn& fn) {
+  ThreadPool::Global().ParallelFor(n, min_grain, fn);
+}
+
+}  // namespace ort_extensions
@@ -2,9 +2,12 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <string>
 #include <vector>
 #include <string_view>
 
+#include "utf8.h"
+
 // ustring needs a new implementation, due to the std::codecvt deprecation.
 // Wrap u32string with ustring, in case we will use other implementation in the future
 class ustring : public std::u32string {
@@ -58,60 +61,37 @@ class ustring : public std::u32string {
     return std::string(utf8_buf);
   }
 
-  static bool ValidateUTF8(const std::string& data) {
-    int cnt = 0;
-    for (auto i = 0; i < data.size(); i++) {
-      int x = data[i];
-      if (!cnt) {
-        if ((x >> 5) == 0b110) {
-          cnt = 1;
-        } else if ((x >> 4) == 0b1110) {
-          cnt = 2;
-        } else if ((x >> 3) == 0b11110) {
-          cnt = 3;
-        } else if ((x >> 7) != 0) {
-          return false;
-        }
-      } else {
-        if ((x >> 6) != 0b10) return false;
-        cnt--;
-      }
+  static bool ValidateUTF8(std::string_view data) {
+    return ort_extensions::ValidateUTF8(data.data(), data.size());
+  }
+
+  // Decodes utf8 into ucs32. Returns false and leaves ucs32 empty if the input is not well-formed UTF-8,
+  // unlike the constructors, which replace each malformed sequence with U+FFFD.
+  static bool DecodeUTF8(std::string_view utf8, ustring& ucs32) {
+    ucs32.resize(utf8.size());
+    auto n = ort_extensions::ConvertUTF8ToUTF32(utf8.data(), utf8.size(), &ucs32[0]);
+    if (n == ort_extensions::kInvalidUTF8) {
+      ucs32.clear();
+      return false;
     }
-    return cnt == 0;
+
+    ucs32.resize(n);
+    return true;
   }
 
  private:
   using u32string = std::u32string;
   static u32string FromUTF8(const std::string_view& utf8) {
     u32string ucs32;
-    ucs32.reserve(utf8.length() / 2);  // a rough estimation for less memory allocation.
-    for (size_t i = 0; i < utf8.size();) {
-      char32_t codepoint = 0;
-      if ((utf8[i] & 0x80) == 0) {
-        codepoint = utf8[i];
-        i++;
-      } else if ((utf8[i] & 0xE0) == 0xC0) {
-        codepoint = ((utf8[i] & 0x1F) << 6) | (utf8[i + 1] & 0x3F);
-        i += 2;
-      } else if ((utf8[i] & 0xF0) == 0xE0) {
-        codepoint = ((utf8[i] & 0x0F) << 12) | ((utf8[i + 1] & 0x3F) << 6) | (utf8[i + 2] & 0x3F);
-        i += 3;
-      } else {
-        codepoint = ((utf8[i] & 0x07) << 18) | ((utf8[i + 1] & 0x3F) << 12) | ((utf8[i + 2] & 0x3F) << 6) | (utf8[i + 3] & 0x3F);
-        i += 4;
-      }
-      ucs32.push_back(codepoint);
-    }
+    ucs32.resize(utf8.size());  // never more code points than bytes
+    ucs32.resize(ort_extensions::ConvertUTF8ToUTF32Lossy(utf8.data(), utf8.size(), &ucs32[0]));
     return ucs32;
   }
 
   static std::string ToUTF8(const u32string& ucs32) {
     std::string utf8;
-    utf8.reserve(ucs32.length() * 4);
-    for (char32_t codepoint : ucs32) {
-      utf8 += EncodeUTF8Char(codepoint);
-    }
-
+    utf8.resize(ucs32.size() * 4);
+    utf8.resize(ort_extensions::ConvertUTF32ToUTF8(ucs32.data(), ucs32.size(), &utf8[0]));
     return utf8;
   }
 };
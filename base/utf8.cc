@@ -0,0 +1,384 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "utf8.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OCOS_UTF8_AVX2
+#define OCOS_UTF8_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCOS_UTF8_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCOS_UTF8_NEON
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ort_extensions {
+namespace {
+
+inline unsigned CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// Decodes the multi-byte sequence at p (p[0] >= 0x80). On success returns the sequence length and stores the
+// code point in cp. If the sequence is malformed, returns the negated length of its maximal invalid subpart,
+// which is what a lossy decoder replaces with a single U+FFFD.
+inline int DecodeSequence(const uint8_t* p, size_t avail, char32_t& cp) {
+  const uint8_t lead = p[0];
+  uint8_t lo = 0x80;
+  uint8_t hi = 0xBF;
+  int n;
+  char32_t c;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    n = 2;
+    c = lead & 0x1F;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    n = 3;
+    c = lead & 0x0F;
+    if (lead == 0xE0) {
+      lo = 0xA0;  // overlong
+    } else if (lead == 0xED) {
+      hi = 0x9F;  // surrogates
+    }
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    n = 4;
+    c = lead & 0x07;
+    if (lead == 0xF0) {
+      lo = 0x90;  // overlong
+    } else if (lead == 0xF4) {
+      hi = 0x8F;  // above U+10FFFF
+    }
+  } else {
+    return -1;
+  }
+
+  for (int k = 1; k < n; ++k) {
+    if (static_cast<size_t>(k) >= avail) {
+      return -k;
+    }
+    const uint8_t b = p[k];
+    if (b < lo || b > hi) {
+      return -k;
+    }
+    lo = 0x80;
+    hi = 0xBF;
+    c = (c << 6) | (b & 0x3F);
+  }
+
+  cp = c;
+  return n;
+}
+
+inline size_t EncodeCodePoint(char32_t c, char* dst) {
+  if (c <= 0x7F) {
+    dst[0] = static_cast<char>(c);
+    return 1;
+  } else if (c <= 0x7FF) {
+    dst[0] = static_cast<char>(0xC0 | (c >> 6));
+    dst[1] = static_cast<char>(0x80 | (c & 0x3F));
+    return 2;
+  } else if (c <= 0xFFFF) {
+    dst[0] = static_cast<char>(0xE0 | (c >> 12));
+    dst[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    dst[2] = static_cast<char>(0x80 | (c & 0x3F));
+    return 3;
+  } else {
+    dst[0] = static_cast<char>(0xF0 | (c >> 18));
+    dst[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+    dst[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    dst[3] = static_cast<char>(0x80 | (c & 0x3F));
+    return 4;
+  }
+}
+
+// Returns the length of the ASCII prefix of [p, p + len).
+inline size_t SkipAscii(const uint8_t* p, size_t len) {
+  size_t i = 0;
+#if defined(OCOS_UTF8_AVX2)
+  for (; i + 32 <= len; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+    const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    if (mask != 0) {
+      return i + CountTrailingZeros(mask);
+    }
+  }
+#endif
+#if defined(OCOS_UTF8_SSE2)
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+    if (mask != 0) {
+      return i + CountTrailingZeros(mask);
+    }
+  }
+#elif defined(OCOS_UTF8_NEON)
+  for (; i + 16 <= len; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(p + i)) >= 0x80) {
+      break;
+    }
+  }
+#endif
+  while (i < len && p[i] < 0x80) {
+    ++i;
+  }
+  return i;
+}
+
+// Widens the ASCII prefix of [p, p + len) into dst and returns its length.
+inline size_t WidenAscii(const uint8_t* p, size_t len, char32_t* dst) {
+  size_t i = 0;
+#if defined(OCOS_UTF8_AVX2)
+  for (; i + 32 <= len; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+    if (_mm256_movemask_epi8(v) != 0) {
+      break;
+    }
+    for (size_t k = 0; k < 32; k += 8) {
+      const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + i + k));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + k), _mm256_cvtepu8_epi32(bytes));
+    }
+  }
+#endif
+#if defined(OCOS_UTF8_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    if (_mm_movemask_epi8(v) != 0) {
+      break;
+    }
+    const __m128i lo = _mm_unpacklo_epi8(v, zero);
+    const __m128i hi = _mm_unpackhi_epi8(v, zero);
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+  }
+#elif defined(OCOS_UTF8_NEON)
+  for (; i + 16 <= len; i += 16) {
+    const uint8x16_t v = vld1q_u8(p + i);
+    if (vmaxvq_u8(v) >= 0x80) {
+      break;
+    }
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+    const uint16x8_t hi = vmovl_high_u8(v);
+    uint32_t* out = reinterpret_cast<uint32_t*>(dst + i);
+    vst1q_u32(out, vmovl_u16(vget_low_u16(lo)));
+    vst1q_u32(out + 4, vmovl_high_u16(lo));
+    vst1q_u32(out + 8, vmovl_u16(vget_low_u16(hi)));
+    vst1q_u32(out + 12, vmovl_high_u16(hi));
+  }
+#endif
+  for (; i < len && p[i] < 0x80; ++i) {
+    dst[i] = p[i];
+  }
+  return i;
+}
+
+// Narrows the ASCII prefix of [src, src + len), in whole blocks only, into dst and returns its length.
+inline size_t NarrowAsciiBlocks(const char32_t* src, size_t len, char* dst) {
+  size_t i = 0;
+#if defined(OCOS_UTF8_SSE2)
+  const __m128i non_ascii = _mm_set1_epi32(~0x7F);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= len; i += 16) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+    const __m128i a = _mm_loadu_si128(in);
+    const __m128i b = _mm_loadu_si128(in + 1);
+    const __m128i c = _mm_loadu_si128(in + 2);
+    const __m128i d = _mm_loadu_si128(in + 3);
+    const __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, non_ascii), zero)) != 0xFFFF) {
+      break;
+    }
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+  }
+#elif defined(OCOS_UTF8_NEON)
+  for (; i + 16 <= len; i += 16) {
+    const uint32_t* in = reinterpret_cast<const uint32_t*>(src + i);
+    const uint32x4_t a = vld1q_u32(in);
+    const uint32x4_t b = vld1q_u32(in + 4);
+    const uint32x4_t c = vld1q_u32(in + 8);
+    const uint32x4_t d = vld1q_u32(in + 12);
+    if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) {
+      break;
+    }
+    const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+    const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+  }
+#else
+  (void)src;
+  (void)len;
+  (void)dst;
+#endif
+  return i;
+}
+
+template <bool kLossy>
+size_t DecodeUTF8(const char* src, size_t len, char32_t* dst) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
+  size_t i = 0;
+  size_t n = 0;
+  while (i < len) {
+    const size_t ascii = WidenAscii(p + i, len - i, dst + n);
+    i += ascii;
+    n += ascii;
+    while (i < len && p[i] >= 0x80) {
+      char32_t cp;
+      const int step = DecodeSequence(p + i, len - i, cp);
+      if (step > 0) {
+        dst[n++] = cp;
+        i += step;
+      } else if (kLossy) {
+        dst[n++] = 0xFFFD;
+        i += -step;
+      } else {
+        return kInvalidUTF8;
+      }
+    }
+  }
+
+  return n;
+}
+
+}  // namespace
+
+bool ValidateUTF8(const char* data, size_t len) noexcept {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  size_t i = 0;
+  while (i < len) {
+    i += SkipAscii(p + i, len - i);
+    while (i < len && p[i] >= 0x80) {
+      char32_t cp;
+      const int step = DecodeSequence(p + i, len - i, cp);
+      if (step < 0) {
+        return false;
+      }
+      i += step;
+    }
+  }
+
+  return true;
+}
+
+size_t CountUTF8CodePoints(const char* data, size_t len) noexcept {
+  // the continuation bytes, 0x80 to 0xBF, are the ones below -64 as signed bytes. The vector loops count the other
+  // ones in per-lane byte counters, summed before they can overflow, every 255 blocks.
+  const int8_t* p = reinterpret_cast<const int8_t*>(data);
+  size_t i = 0;
+  size_t count = 0;
+#if defined(OCOS_UTF8_AVX2)
+  {
+    const __m256i threshold = _mm256_set1_epi8(-65);
+    const __m256i zero = _mm256_setzero_si256();
+    while (i + 32 <= len) {
+      const size_t blocks = (len - i) / 32 < 255 ? (len - i) / 32 : 255;
+      __m256i counters = zero;
+      for (size_t b = 0; b < blocks; ++b, i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        counters = _mm256_sub_epi8(counters, _mm256_cmpgt_epi8(v, threshold));
+      }
+      const __m256i sums = _mm256_sad_epu8(counters, zero);
+      const __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+      count += static_cast<size_t>(_mm_cvtsi128_si32(halves)) + static_cast<size_t>(_mm_extract_epi16(halves, 4));
+    }
+  }
+#endif
+#if defined(OCOS_UTF8_SSE2)
+  {
+    const __m128i threshold = _mm_set1_epi8(-65);
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 16 <= len) {
+      const size_t blocks = (len - i) / 16 < 255 ? (len - i) / 16 : 255;
+      __m128i counters = zero;
+      for (size_t b = 0; b < blocks; ++b, i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(v, threshold));
+      }
+      const __m128i sums = _mm_sad_epu8(counters, zero);
+      count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+    }
+  }
+#elif defined(OCOS_UTF8_NEON)
+  {
+    const int8x16_t threshold = vdupq_n_s8(-65);
+    while (i + 16 <= len) {
+      const size_t blocks = (len - i) / 16 < 255 ? (len - i) / 16 : 255;
+      uint8x16_t counters = vdupq_n_u8(0);
+      for (size_t b = 0; b < blocks; ++b, i += 16) {
+        counters = vsubq_u8(counters, vcgtq_s8(vld1q_s8(p + i), threshold));
+      }
+      count += vaddlvq_u8(counters);
+    }
+  }
+#endif
+  for (; i < len; ++i) {
+    count += p[i] > -65 ? 1 : 0;
+  }
+  return count;
+}
+
+size_t AsciiPrefixLength(const char* data, size_t len) noexcept {
+  return SkipAscii(reinterpret_cast<const uint8_t*>(data), len);
+}
+
+size_t UTF8CharLength(const char* data, size_t len) noexcept {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  if (p[0] < 0x80) {
+    return 1;
+  }
+  char32_t cp;
+  const int step = DecodeSequence(p, len, cp);
+  return static_cast<size_t>(step > 0 ? step : -step);
+}
+
+size_t DecodeUTF8Char(const char* data, size_t len, char32_t& cp) noexcept {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  if (p[0] < 0x80) {
+    cp = p[0];
+    return 1;
+  }
+  const int step = DecodeSequence(p, len, cp);
+  return step > 0 ? static_cast<size_t>(step) : kInvalidUTF8;
+}
+
+size_t ConvertUTF8ToUTF32(const char* src, size_t len, char32_t* dst) noexcept {
+  return DecodeUTF8<false>(src, len, dst);
+}
+
+size_t ConvertUTF8ToUTF32Lossy(const char* src, size_t len, char32_t* dst) noexcept {
+  return DecodeUTF8<true>(src, len, dst);
+}
+
+size_t ConvertUTF32ToUTF8(const char32_t* src, size_t len, char* dst) noexcept {
+  size_t i = 0;
+  size_t n = 0;
+  while (i < len) {
+    const size_t ascii = NarrowAsciiBlocks(src + i, len - i, dst + n);
+    i += ascii;
+    n += ascii;
+    // encode up to the next block boundary one code point at a time, then try the vector path again.
+    const size_t block_end = i + 16 < len ? i + 16 : len;
+    for (; i < block_end; ++i) {
+      n += EncodeCodePoint(src[i], dst + n);
+    }
+  }
+
+  return n;
+}
+
+}  // namespace ort_extensions
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// UTF-8 <=> UTF-32 transcoding and validation.
+// ASCII runs are processed in 16-byte (SSE2/NEON) or 32-byte (AVX2) blocks, multi-byte sequences go through a
+// scalar decoder that checks for truncation, overlong forms, surrogates and code points above U+10FFFF.
+// None of the functions allocate; the caller provides the output buffers.
+namespace ort_extensions {
+
+// Returned by the conversion functions when the input is not well-formed.
+constexpr size_t kInvalidUTF8 = static_cast<size_t>(-1);
+
+// Returns true if [data, data + len) is well-formed UTF-8.
+bool ValidateUTF8(const char* data, size_t len) noexcept;
+
+// Decodes [src, src + len) into dst, which must have room for at least `len` code points.
+// Returns the number of code points written, or kInvalidUTF8 if the input is malformed.
+size_t ConvertUTF8ToUTF32(const char* src, size_t len, char32_t* dst) noexcept;
+
+// Same as ConvertUTF8ToUTF32 but replaces each malformed sequence with U+FFFD instead of failing.
+size_t ConvertUTF8ToUTF32Lossy(const char* src, size_t len, char32_t* dst) noexcept;
+
+// Returns the number of bytes of [data, data + len) that do not continue a multi-byte sequence, which is the number
+// of code points when the input is well-formed. Counts in vector registers, without decoding.
+size_t CountUTF8CodePoints(const char* data, size_t len) noexcept;
+
+// Returns the length of the ASCII prefix of [data, data + len).
+size_t AsciiPrefixLength(const char* data, size_t len) noexcept;
+
+// Returns the number of bytes of the character starting at data, len > 0. A malformed sequence counts as one
+// character spanning its maximal invalid subpart, the bytes the lossy conversion replaces with one U+FFFD.
+size_t UTF8CharLength(const char* data, size_t len) noexcept;
+
+// Decodes the character starting at data, len > 0, into cp and returns its length in bytes,
+// or kInvalidUTF8 if the sequence is malformed.
+size_t DecodeUTF8Char(const char* data, size_t len, char32_t& cp) noexcept;
+
+// Encodes [src, src + len) into dst, which must have room for at least 4 * `len` bytes.
+// Returns the number of bytes written.
+size_t ConvertUTF32ToUTF8(const char32_t* src, size_t len, char* dst) noexcept;
+
+}  // namespace ort_extensions
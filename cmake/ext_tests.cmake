@@ -127,6 +127,18 @@ add_test_target(TARGET ocos_test
                 TEST_SOURCES ${static_TEST_SRC}
                 LIBRARIES ortcustomops ${ocos_libraries})
 
+# -- audio benchmark --
+if(OCOS_ENABLE_BENCHMARK AND OCOS_ENABLE_AUDIO AND NOT IOS)
+  message(STATUS "Fetch googlebenchmark")
+  include(googlebenchmark)
+
+  # not a test: run it with --benchmark_out=<file> --benchmark_out_format=json for machine-readable results.
+  add_executable(audio_benchmark "${TEST_SRC_DIR}/benchmark/audio_benchmark.cc")
+  standardize_output_folder(audio_benchmark)
+  target_link_libraries(audio_benchmark PRIVATE ortcustomops ${ocos_libraries} benchmark::benchmark)
+  target_compile_definitions(audio_benchmark PRIVATE AUDIO_BENCHMARK_DATA_DIR="${TEST_SRC_DIR}/data")
+endif()
+
 # -- shared test (needs onnxruntime) --
 SET(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY BOTH)
 find_library(ONNXRUNTIME onnxruntime HINTS "${ONNXRUNTIME_LIB_DIR}")
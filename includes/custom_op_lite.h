@@ -3,8 +3,11 @@
 
 #pragma once
 #include "onnxruntime_customop.hpp"
+#include "op_arena.h"
 #include <optional>
 #include <numeric>
+#include <iterator>
+#include <string_view>
 
 namespace Ort {
 namespace Custom {
@@ -151,6 +154,66 @@ class Tensor : public TensorBase {
   Span<T> span_;
 };
 
+// Collects the elements of a string output tensor in one growing buffer.
+// Each element is stored null-terminated, so the whole tensor is handed to ORT without per-element copies.
+// An element is either added at once with Append(), or built piecewise with Extend() and closed with EndElement().
+class StringTensorBuilder {
+ public:
+  void Reserve(size_t num_strings, size_t num_bytes) {
+    starts_.reserve(num_strings);
+    buffer_.reserve(num_bytes + num_strings);
+  }
+  void Append(std::string_view str) {
+    Extend(str);
+    EndElement();
+  }
+  void Extend(std::string_view bytes) {
+    buffer_.insert(buffer_.end(), bytes.begin(), bytes.end());
+  }
+  void Extend(char c) {
+    buffer_.push_back(c);
+  }
+  void EndElement() {
+    starts_.push_back(element_start_);
+    buffer_.push_back('\0');
+    element_start_ = buffer_.size();
+  }
+  // Adds an element of `length` bytes for the caller to fill in through MutableElement(); used when the output
+  // size is known up front and the elements are written concurrently once all of them are added.
+  void AppendUninitialized(size_t length) {
+    buffer_.resize(buffer_.size() + length);
+    EndElement();
+  }
+  // Discards the bytes added to the element under construction.
+  void DropElement() {
+    buffer_.resize(element_start_);
+  }
+  void Clear() {
+    buffer_.clear();
+    starts_.clear();
+    element_start_ = 0;
+  }
+  size_t size() const {
+    return starts_.size();
+  }
+  std::string_view operator[](size_t i) const {
+    size_t end = i + 1 < starts_.size() ? starts_[i + 1] : element_start_;
+    return std::string_view(buffer_.data() + starts_[i], end - starts_[i] - 1);
+  }
+  const char* c_str(size_t i) const {
+    return buffer_.data() + starts_[i];
+  }
+  // Valid until the next element is added.
+  char* MutableElement(size_t i) {
+    return buffer_.data() + starts_[i];
+  }
+
+ private:
+  std::vector<char> buffer_;
+  std::vector<size_t> starts_;
+  size_t element_start_{};
+};
+
 template <>
 class Tensor<std::string> : public TensorBase {
  public:
@@ -169,46 +232,34 @@ class Tensor<std::string> : public TensorBase {
         ORTX_CXX_API_THROW("invalid indice", ORT_RUNTIME_EXCEPTION);
       }
 
-      auto* const_value = api_.KernelContext_GetInput(&ctx_, indice);
-      auto* info = api_.GetTensorTypeAndShape(const_value);
+      const_value_ = api_.KernelContext_GetInput(&ctx_, indice);
+      auto* info = api_.GetTensorTypeAndShape(const_value_);
       shape_ = api_.GetTensorShape(info);
       type_ = ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING;
       api_.ReleaseTensorTypeAndShapeInfo(info);
-
-      size_t num_chars;
-      OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorDataLength(const_value, &num_chars));
-      std::vector<char> chars(num_chars + 1, '\0');
-      auto num_strings = NumberOfElement();
-      std::vector<size_t> offsets(NumberOfElement());
-      OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorContent(const_value,
-                                                                                   (void*)chars.data(),
-                                                                                   num_chars,
-                                                                                   offsets.data(),
-                                                                                   offsets.size()));
-      auto upper_bound = static_cast<int64_t>(num_strings) - 1;
-      input_strings_.resize(num_strings);
-      for (int64_t i = upper_bound; i >= 0; --i) {
-        if (i < upper_bound) {
-          chars[offsets[i + 1]] = '\0';
-        }
-        input_strings_[i] = chars.data() + offsets[i];
-      }
     }
   }
+  // The string content is fetched from ORT on the first call, not when the tensor is constructed.
+  // Call it once before sharing the tensor across threads.
   const strings& Data() const {
+    if (const_value_ && !loaded_) {
+      LoadStrings();
+    }
     return input_strings_;
   }
   const void* DataRaw() const override {
-    if (input_strings_.size() != 1) {
+    const auto& input_strings = Data();
+    if (input_strings.size() != 1) {
       ORTX_CXX_API_THROW("DataRaw() only applies to string scalar", ORT_RUNTIME_EXCEPTION);
     }
-    return reinterpret_cast<const void*>(input_strings_[0].c_str());
+    return reinterpret_cast<const void*>(input_strings[0].c_str());
   }
   size_t SizeInBytes() const override {
-    if (input_strings_.size() != 1) {
+    const auto& input_strings = Data();
+    if (input_strings.size() != 1) {
       ORTX_CXX_API_THROW("SizeInBytes() only applies to string scalar", ORT_RUNTIME_EXCEPTION);
     }
-    return input_strings_[0].size();
+    return input_strings[0].size();
   }
   void SetStringOutput(const strings& ss, const std::vector<int64_t>& dims) {
     std::vector<const char*> raw;
@@ -222,6 +273,13 @@ class Tensor<std::string> : public TensorBase {
     auto* output = api_.KernelContext_GetOutput(&ctx_, indice_, dims.data(), dims.size());
     OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().FillStringTensor(output, ss.data(), ss.size()));
   }
+  void SetStringOutput(const StringTensorBuilder& builder, const std::vector<int64_t>& dims) {
+    std::vector<const char*> raw(builder.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+      raw[i] = builder.c_str(i);
+    }
+    SetStringOutput(raw, dims);
+  }
   const Span<std::string>& AsSpan() {
     ORTX_CXX_API_THROW("span for TensorT of string not implemented", ORT_RUNTIME_EXCEPTION);
   }
@@ -229,18 +287,111 @@ class Tensor<std::string> : public TensorBase {
     if (!shape_.has_value() || (shape_->size() == 1 && (*shape_)[0] != 1) || shape_->size() > 1) {
       ORTX_CXX_API_THROW("to get a scalar, shape must be {1}, actual shape: " + Shape2Str(), ORT_RUNTIME_EXCEPTION);
     }
-    return input_strings_[0];
+    return Data()[0];
   }
 
  private:
-  std::vector<std::string> input_strings_;  // for input
+  void LoadStrings() const {
+    size_t num_chars;
+    OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorDataLength(const_value_, &num_chars));
+    auto num_strings = static_cast<size_t>(NumberOfElement());
+    input_strings_.resize(num_strings);
+    if (num_strings) {
+      std::vector<char> chars(num_chars + 1, '\0');
+      std::vector<size_t> offsets(num_strings + 1);
+      OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorContent(const_value_,
+                                                                                   (void*)chars.data(),
+                                                                                   num_chars,
+                                                                                   offsets.data(),
+                                                                                   num_strings));
+      offsets[num_strings] = num_chars;
+      for (size_t i = 0; i < num_strings; ++i) {
+        input_strings_[i].assign(chars.data() + offsets[i], offsets[i + 1] - offsets[i]);
+      }
+    }
+    loaded_ = true;
+  }
+
+  const OrtValue* const_value_{};                   // for input
+  mutable bool loaded_{};                           // for input
+  mutable std::vector<std::string> input_strings_;  // for input
+};
+
+// A read-only sequence of std::string_view over the content of a string tensor.
+// The elements share one character buffer and are delimited by an offsets array, so no per-element storage exists.
+class StringViews {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = std::string_view;
+
+    const_iterator(const StringViews* owner, size_t index) : owner_(owner), index_(index) {}
+    std::string_view operator*() const { return (*owner_)[index_]; }
+    std::string_view operator[](difference_type n) const { return (*owner_)[index_ + n]; }
+    const_iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto it = *this;
+      ++index_;
+      return it;
+    }
+    const_iterator& operator--() {
+      --index_;
+      return *this;
+    }
+    const_iterator& operator+=(difference_type n) {
+      index_ += n;
+      return *this;
+    }
+    const_iterator operator+(difference_type n) const { return {owner_, index_ + n}; }
+    const_iterator operator-(difference_type n) const { return {owner_, index_ - n}; }
+    difference_type operator-(const const_iterator& rhs) const {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(rhs.index_);
+    }
+    bool operator==(const const_iterator& rhs) const { return index_ == rhs.index_; }
+    bool operator!=(const const_iterator& rhs) const { return index_ != rhs.index_; }
+    bool operator<(const const_iterator& rhs) const { return index_ < rhs.index_; }
+
+   private:
+    const StringViews* owner_;
+    size_t index_;
+  };
+
+  StringViews() = default;
+  // offsets holds size + 1 entries, the last one being the total length of chars.
+  StringViews(const char* chars, const size_t* offsets, size_t size) : chars_(chars), offsets_(offsets), size_(size) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::string_view operator[](size_t i) const {
+    return std::string_view(chars_ + offsets_[i], offsets_[i + 1] - offsets_[i]);
+  }
+  std::string_view at(size_t i) const {
+    if (i >= size_) {
+      ORTX_CXX_API_THROW("string tensor index out of range", ORT_RUNTIME_EXCEPTION);
+    }
+    return (*this)[i];
+  }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, size_}; }
+
+ private:
+  const char* chars_{};
+  const size_t* offsets_{};
+  size_t size_{};
 };
 
 template <>
 class Tensor<std::string_view> : public TensorBase {
  public:
   using strings = std::vector<std::string>;
-  using string_views = std::vector<std::string_view>;
+  using string_views = StringViews;
 
   Tensor(const OrtW::CustomOpApi& api,
          OrtKernelContext& ctx,
@@ -254,29 +405,11 @@ class Tensor<std::string_view> : public TensorBase {
       if (indice >= input_count) {
         ORTX_CXX_API_THROW("invalid indice", ORT_RUNTIME_EXCEPTION);
       }
-      auto* const_value = api_.KernelContext_GetInput(&ctx_, indice);
-      auto* info = api_.GetTensorTypeAndShape(const_value);
+      const_value_ = api_.KernelContext_GetInput(&ctx_, indice);
+      auto* info = api_.GetTensorTypeAndShape(const_value_);
       shape_ = api_.GetTensorShape(info);
       type_ = ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING;
       api_.ReleaseTensorTypeAndShapeInfo(info);
-
-      size_t num_chars;
-      OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorDataLength(const_value, &num_chars));
-      chars_.resize(num_chars + 1, '\0');
-
-      auto num_strings = static_cast<size_t>(NumberOfElement());
-      if (num_strings) {
-        std::vector<size_t> offsets(num_strings);
-        OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorContent(const_value,
-                                                                                     (void*)chars_.data(),
-                                                                                     num_chars,
-                                                                                     offsets.data(),
-                                                                                     offsets.size()));
-        offsets.push_back(num_chars);
-        for (size_t i = 0; i < num_strings; ++i) {
-          input_string_views_.emplace_back(chars_.data() + offsets[i], offsets[i + 1] - offsets[i]);
-        }
-      }
     }
   }
   int64_t NumberOfElement() const {
@@ -286,20 +419,26 @@ class Tensor<std::string_view> : public TensorBase {
       return 0;
     }
   }
+  // Like Tensor<std::string>::Data(), the content is fetched on the first call.
   const string_views& Data() const {
+    if (const_value_ && !loaded_) {
+      LoadStrings();
+    }
     return input_string_views_;
   }
   const void* DataRaw() const override {
-    if (input_string_views_.size() != 1) {
+    const auto& input_string_views = Data();
+    if (input_string_views.size() != 1) {
       ORTX_CXX_API_THROW("DataRaw() only applies to string scalar", ORT_RUNTIME_EXCEPTION);
     }
-    return reinterpret_cast<const void*>(input_string_views_[0].data());
+    return reinterpret_cast<const void*>(input_string_views[0].data());
   }
   size_t SizeInBytes() const override {
-    if (input_string_views_.size() != 1) {
+    const auto& input_string_views = Data();
+    if (input_string_views.size() != 1) {
       ORTX_CXX_API_THROW("SizeInBytes() only applies to string scalar", ORT_RUNTIME_EXCEPTION);
     }
-    return input_string_views_[0].size();
+    return input_string_views[0].size();
   }
   const Span<std::string_view>& AsSpan() {
     ORTX_CXX_API_THROW("span for TensorT of string view not implemented", ORT_RUNTIME_EXCEPTION);
@@ -308,12 +447,35 @@ class Tensor<std::string_view> : public TensorBase {
     if (!shape_.has_value() || (shape_->size() == 1 && (*shape_)[0] != 1) || shape_->size() > 1) {
       ORTX_CXX_API_THROW("to get a scalar, shape must be {1}, actual shape: " + Shape2Str(), ORT_RUNTIME_EXCEPTION);
     }
-    return input_string_views_[0];
+    return Data()[0];
   }
 
  private:
-  std::vector<char> chars_;                           // for input
-  std::vector<std::string_view> input_string_views_;  // for input
+  void LoadStrings() const {
+    size_t num_chars;
+    OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorDataLength(const_value_, &num_chars));
+    // one extra zero so that the data() of a scalar is null-terminated.
+    chars_.resize(num_chars + 1, '\0');
+
+    auto num_strings = static_cast<size_t>(NumberOfElement());
+    if (num_strings) {
+      offsets_.resize(num_strings + 1);
+      OrtW::ThrowOnError(api_.GetOrtApi(), api_.GetOrtApi().GetStringTensorContent(const_value_,
+                                                                                   (void*)chars_.data(),
+                                                                                   num_chars,
+                                                                                   offsets_.data(),
+                                                                                   num_strings));
+      offsets_[num_strings] = num_chars;
+      input_string_views_ = StringViews(chars_.data(), offsets_.data(), num_strings);
+    }
+    loaded_ = true;
+  }
+
+  const OrtValue* const_value_{};           // for input
+  mutable bool loaded_{};                   // for input
+  mutable std::vector<char> chars_;         // for input
+  mutable std::vector<size_t> offsets_;     // for input, NumberOfElement() + 1 entries
+  mutable StringViews input_string_views_;  // for input
 };
 
 using TensorPtr = std::unique_ptr<Custom::TensorBase>;
@@ -434,6 +596,14 @@ struct OrtLiteCustomOp : public OrtCustomOp {
     return std::tuple_cat(current, next);
   }
 
+  template <size_t ith_input, size_t ith_output, typename T, typename... Ts>
+  static typename std::enable_if<std::is_same<T, ComputeArena&>::value, std::tuple<T, Ts...>>::type
+  CreateTuple(const OrtW::CustomOpApi* api, OrtKernelContext* context, std::vector<TensorPtr>& tensors, size_t num_input, size_t num_output, const std::string& ep) {
+    std::tuple<T> current = std::tuple<ComputeArena&>{ComputeArena::ThreadLocal()};
+    auto next = CreateTuple<ith_input, ith_output, Ts...>(api, context, tensors, num_input, num_output, ep);
+    return std::tuple_cat(current, next);
+  }
+
 #if ORT_API_VERSION >= 14
   template <size_t ith_input, size_t ith_output, typename T, typename... Ts>
   static typename std::enable_if<std::is_same<T, const Variadic*>::value, std::tuple<T, Ts...>>::type
@@ -631,6 +801,12 @@ struct OrtLiteCustomOp : public OrtCustomOp {
     ParseArgs<Ts...>(input_types, output_types);
   }
 
+  template <typename T, typename... Ts>
+  static typename std::enable_if<0 <= sizeof...(Ts) && std::is_same<T, ComputeArena&>::value>::type
+  ParseArgs(std::vector<ONNXTensorElementDataType>& input_types, std::vector<ONNXTensorElementDataType>& output_types) {
+    ParseArgs<Ts...>(input_types, output_types);
+  }
+
 #if ORT_API_VERSION >= 14
   template <typename T, typename... Ts>
   static typename std::enable_if<0 <= sizeof...(Ts) && std::is_same<T, const Variadic&>::value>::type
@@ -807,6 +983,9 @@ struct OrtLiteCustomOp : public OrtCustomOp {
 
   std::vector<ONNXTensorElementDataType> input_types_;
   std::vector<ONNXTensorElementDataType> output_types_;
+
+  // updated by the Compute calls of all kernels created from this op.
+  mutable OpMemoryStats memory_stats_;
 };
 
 template <typename... Args>
@@ -818,6 +997,7 @@ struct OrtLiteCustomFunc : public OrtLiteCustomOp {
     ComputeFn compute_fn_{};
     std::string ep_{};
     std::unique_ptr<OrtW::CustomOpApi> api_;
+    const OrtLiteCustomOp* op_{};
   };
 
   OrtLiteCustomFunc(const char* op_name,
@@ -828,6 +1008,7 @@ struct OrtLiteCustomFunc : public OrtLiteCustomOp {
 
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) {
       auto kernel = reinterpret_cast<Kernel*>(op_kernel);
+      ComputeArenaScope arena_scope(kernel->op_->op_name_.c_str(), kernel->op_->memory_stats_);
       std::vector<TensorPtr> tensors;
       auto t = CreateTuple<0, 0, Args...>(kernel->api_.get(),
                                           context,
@@ -843,6 +1024,7 @@ struct OrtLiteCustomFunc : public OrtLiteCustomOp {
       auto self = static_cast<const OrtLiteCustomFunc*>(this_);
       kernel->compute_fn_ = self->compute_fn_;
       kernel->ep_ = self->execution_provider_;
+      kernel->op_ = self;
       kernel->api_ = std::make_unique<OrtW::CustomOpApi>(*ort_api);
       return reinterpret_cast<void*>(kernel.release());
     };
@@ -865,6 +1047,7 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
     std::unique_ptr<CustomOp> custom_op_;
     std::string ep_{};
     std::unique_ptr<OrtW::CustomOpApi> api_;
+    const OrtLiteCustomOp* op_{};
   };
 
   OrtLiteCustomStruct(const char* op_name,
@@ -879,6 +1062,7 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
 
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) {
       auto kernel = reinterpret_cast<Kernel*>(op_kernel);
+      ComputeArenaScope arena_scope(kernel->op_->op_name_.c_str(), kernel->op_->memory_stats_);
       std::vector<TensorPtr> tensors;
       auto t = CreateTuple<0, 0, Args...>(kernel->api_.get(),
                                           context,
@@ -894,6 +1078,7 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
       kernel->custom_op_ = std::make_unique<CustomOp>(*ort_api, *info);
       auto self = static_cast<const MyType*>(this_);
       kernel->ep_ = self->execution_provider_;
+      kernel->op_ = self;
       kernel->api_ = std::make_unique<OrtW::CustomOpApi>(*ort_api);
       return reinterpret_cast<void*>(kernel.release());
     };
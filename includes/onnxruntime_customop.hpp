@@ -92,6 +92,44 @@ inline OrtStatusPtr API::KernelInfoGetAttribute<std::string>(const OrtKernelInfo
   return status;
 }
 
+template <>
+inline OrtStatusPtr API::KernelInfoGetAttribute<std::vector<int64_t>>(const OrtKernelInfo& info, const char* name,
+                                                                     std::vector<int64_t>& value) noexcept {
+  size_t size = 0;
+  std::vector<int64_t> out;
+  // Feed nullptr for the data buffer to query the number of elements
+  OrtStatus* status = instance()->KernelInfoGetAttributeArray_int64(&info, name, nullptr, &size);
+  if (status == nullptr) {
+    out.resize(size);
+    status = instance()->KernelInfoGetAttributeArray_int64(&info, name, out.data(), &size);
+  }
+
+  if (status == nullptr) {
+    value = std::move(out);
+  }
+
+  return status;
+}
+
+template <>
+inline OrtStatusPtr API::KernelInfoGetAttribute<std::vector<float>>(const OrtKernelInfo& info, const char* name,
+                                                                   std::vector<float>& value) noexcept {
+  size_t size = 0;
+  std::vector<float> out;
+  // Feed nullptr for the data buffer to query the number of elements
+  OrtStatus* status = instance()->KernelInfoGetAttributeArray_float(&info, name, nullptr, &size);
+  if (status == nullptr) {
+    out.resize(size);
+    status = instance()->KernelInfoGetAttributeArray_float(&info, name, out.data(), &size);
+  }
+
+  if (status == nullptr) {
+    value = std::move(out);
+  }
+
+  return status;
+}
+
 template <class T>
 inline OrtStatusPtr GetOpAttribute(const OrtKernelInfo& info, const char* name, T& value) noexcept {
   if (auto status = API::KernelInfoGetAttribute(info, name, value); status) {
@@ -182,6 +220,7 @@ struct OrtLiteCustomStructV2 : public OrtLiteCustomOp {
     struct {
       std::string ep_{};
       std::unique_ptr<OrtW::CustomOpApi> api_;
+      const OrtLiteCustomOp* op_{};
     } extra_;
   };
 
@@ -215,11 +254,13 @@ struct OrtLiteCustomStructV2 : public OrtLiteCustomOp {
 
       kernel->extra_.ep_ = self->execution_provider_;
       kernel->extra_.api_ = std::make_unique<OrtW::CustomOpApi>(*ort_api);
+      kernel->extra_.op_ = self;
       return reinterpret_cast<void*>(kernel.release());
     };
 
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) {
       auto kernel = reinterpret_cast<KernelEx*>(op_kernel);
+      ComputeArenaScope arena_scope(kernel->extra_.op_->op_name_.c_str(), kernel->extra_.op_->memory_stats_);
       std::vector<TensorPtr> tensors;
       auto t = CreateTuple<0, 0, Args...>(kernel->extra_.api_.get(),
                                           context,
@@ -265,6 +306,7 @@ struct OrtLiteCustomStructV2 : public OrtLiteCustomOp {
       if (status == nullptr) {
         kernel->extra_.ep_ = self->execution_provider_;
         kernel->extra_.api_ = std::make_unique<OrtW::CustomOpApi>(*api);
+        kernel->extra_.op_ = self;
         *op_kernel = reinterpret_cast<void*>(kernel.release());
       }
 
@@ -273,6 +315,7 @@ struct OrtLiteCustomStructV2 : public OrtLiteCustomOp {
 
     OrtCustomOp::KernelComputeV2 = [](void* op_kernel, OrtKernelContext* context) -> OrtStatusPtr {
       auto kernel = reinterpret_cast<KernelEx*>(op_kernel);
+      ComputeArenaScope arena_scope(kernel->extra_.op_->op_name_.c_str(), kernel->extra_.op_->memory_stats_);
       std::vector<TensorPtr> tensors;
       auto t = CreateTuple<0, 0, Args...>(kernel->extra_.api_.get(),
                                           context,
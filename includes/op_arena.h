@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+namespace Ort {
+namespace Custom {
+
+// A bump allocator for the scratch memory of one Compute call.
+// Every thread owns one arena (ComputeArena::ThreadLocal()); the lite custom op wrappers rewind it when Compute
+// returns, so the memory handed out during the call is released in O(1) and the blocks are reused by the next call.
+// A kernel receives it by declaring a `Ort::Custom::ComputeArena&` parameter in its Compute function.
+class ComputeArena {
+ public:
+  static constexpr size_t kBlockSize = 64 * 1024;
+  // blocks beyond this are given back to the system on rewinding to an empty arena.
+  static constexpr size_t kMaxRetainedBytes = 16 * 1024 * 1024;
+
+  // Position in the arena, used to rewind nested scopes.
+  struct Mark {
+    size_t block;
+    size_t offset;
+    size_t bytes_in_use;
+  };
+
+  ComputeArena() = default;
+  ComputeArena(const ComputeArena&) = delete;
+  ComputeArena& operator=(const ComputeArena&) = delete;
+
+  static ComputeArena& ThreadLocal() {
+    static thread_local ComputeArena arena;
+    return arena;
+  }
+
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    if (size == 0) {
+      size = 1;
+    }
+
+    while (block_ < blocks_.size()) {
+      auto& block = blocks_[block_];
+      auto base = reinterpret_cast<uintptr_t>(block.data.get());
+      size_t aligned = ((base + offset_ + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+      if (aligned + size <= block.size) {
+        offset_ = aligned + size;
+        return Consume(block.data.get() + aligned, size);
+      }
+      ++block_;
+      offset_ = 0;
+    }
+
+    // the request does not fit into any retained block; oversized requests get a block of their own.
+    size_t block_size = size + alignment > kBlockSize ? size + alignment : kBlockSize;
+    blocks_.push_back({std::unique_ptr<char[]>(new char[block_size]), block_size});
+    retained_bytes_ += block_size;
+    block_ = blocks_.size() - 1;
+    offset_ = 0;
+    return Allocate(size, alignment);
+  }
+
+  Mark GetMark() const {
+    return {block_, offset_, bytes_in_use_};
+  }
+
+  void Rewind(const Mark& mark) {
+    block_ = mark.block;
+    offset_ = mark.offset;
+    bytes_in_use_ = mark.bytes_in_use;
+    if (bytes_in_use_ == 0 && retained_bytes_ > kMaxRetainedBytes) {
+      blocks_.clear();
+      block_ = 0;
+      offset_ = 0;
+      retained_bytes_ = 0;
+    }
+  }
+
+  void Reset() {
+    Rewind({0, 0, 0});
+  }
+
+  size_t BytesInUse() const { return bytes_in_use_; }
+  size_t PeakBytesInUse() const { return peak_bytes_in_use_; }
+  void ResetPeak() { peak_bytes_in_use_ = bytes_in_use_; }
+
+ private:
+  void* Consume(char* p, size_t size) {
+    bytes_in_use_ += size;
+    if (bytes_in_use_ > peak_bytes_in_use_) {
+      peak_bytes_in_use_ = bytes_in_use_;
+    }
+    return p;
+  }
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  size_t block_{};
+  size_t offset_{};
+  size_t bytes_in_use_{};
+  size_t peak_bytes_in_use_{};
+  size_t retained_bytes_{};
+};
+
+// STL allocator over a ComputeArena. deallocate() is a no-op; the memory is reclaimed when the arena rewinds,
+// so containers using it must not outlive the Compute call.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  ArenaAllocator() noexcept : arena_(&ComputeArena::ThreadLocal()) {}
+  explicit ArenaAllocator(ComputeArena& arena) noexcept : arena_(&arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, size_t) noexcept {}
+
+  ComputeArena* arena() const noexcept { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& rhs) const noexcept { return arena_ == rhs.arena(); }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& rhs) const noexcept { return arena_ != rhs.arena(); }
+
+ private:
+  ComputeArena* arena_;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Peak memory of one custom op over the lifetime of the process.
+// Collection is enabled by setting the ORTX_OP_MEMORY_REPORT environment variable; a line is then written to
+// stderr whenever an op reaches a new peak.
+struct OpMemoryStats {
+  std::atomic<size_t> peak_arena_bytes{};
+  // growth of the process peak resident set size observed while the op was running, 0 where not available.
+  std::atomic<size_t> peak_rss_growth_bytes{};
+
+  static bool Enabled() {
+    static const bool enabled = std::getenv("ORTX_OP_MEMORY_REPORT") != nullptr;
+    return enabled;
+  }
+
+  static size_t ProcessPeakRSS() {
+#if defined(_WIN32)
+    return 0;
+#else
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+  }
+
+  void Update(const char* op_name, size_t arena_bytes, size_t rss_growth) {
+    bool raised = UpdateMax(peak_arena_bytes, arena_bytes);
+    raised = UpdateMax(peak_rss_growth_bytes, rss_growth) || raised;
+    if (raised) {
+      std::fprintf(stderr, "[onnxruntime-extensions] %s: peak arena %zu bytes, peak RSS growth %zu bytes\n",
+                   op_name, peak_arena_bytes.load(), peak_rss_growth_bytes.load());
+    }
+  }
+
+ private:
+  static bool UpdateMax(std::atomic<size_t>& target, size_t value) {
+    size_t current = target.load();
+    while (value > current) {
+      if (target.compare_exchange_weak(current, value)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// Rewinds the thread's arena to where it was on construction, and records the op's memory peaks if enabled.
+class ComputeArenaScope {
+ public:
+  ComputeArenaScope(const char* op_name, OpMemoryStats& stats)
+      : arena_(ComputeArena::ThreadLocal()), mark_(arena_.GetMark()), op_name_(op_name), stats_(stats) {
+    if (OpMemoryStats::Enabled()) {
+      arena_.ResetPeak();
+      rss_before_ = OpMemoryStats::ProcessPeakRSS();
+    }
+  }
+
+  ~ComputeArenaScope() {
+    if (OpMemoryStats::Enabled()) {
+      size_t rss_after = OpMemoryStats::ProcessPeakRSS();
+      stats_.Update(op_name_, arena_.PeakBytesInUse() - mark_.bytes_in_use,
+                    rss_after > rss_before_ ? rss_after - rss_before_ : 0);
+    }
+    arena_.Rewind(mark_);
+  }
+
+  ComputeArenaScope(const ComputeArenaScope&) = delete;
+  ComputeArenaScope& operator=(const ComputeArenaScope&) = delete;
+
+ private:
+  ComputeArena& arena_;
+  ComputeArena::Mark mark_;
+  const char* op_name_;
+  OpMemoryStats& stats_;
+  size_t rss_before_{};
+};
+
+}  // namespace Custom
+}  // namespace Ort
@@ -198,6 +198,49 @@ class StringToVector(CustomOp):
         return attr_data
 
 
+class StringToHashBucketMultiSeed(CustomOp):
+
+    @classmethod
+    def get_inputs(cls):
+        return [
+            cls.io_def("input", onnx.TensorProto.STRING, None),
+            cls.io_def("num_buckets", onnx.TensorProto.INT64, [1])
+        ]
+
+    @classmethod
+    def get_outputs(cls):
+        return [cls.io_def('output', onnx_proto.TensorProto.INT64, None)]
+
+
+class TextPipeline(CustomOp):
+
+    @classmethod
+    def get_inputs(cls):
+        return [cls.io_def("input", onnx.TensorProto.STRING, [None])]
+
+    @classmethod
+    def get_outputs(cls):
+        return [
+            cls.io_def('ids', onnx_proto.TensorProto.INT64, [None]),
+            cls.io_def('row_splits', onnx_proto.TensorProto.INT64, [None])
+        ]
+
+    @classmethod
+    def serialize_attr(cls, attrs):
+        attr_data = {}
+        for k_, v_ in attrs.items():
+            if k_ == 'steps' and isinstance(v_, list):
+                attr_data[k_] = ','.join(v_)
+            elif k_ == 'map' and isinstance(v_, dict):
+                # the lookup vocabulary in the StringToVector format, one id per key.
+                attr_data[k_] = '\n'.join(k + "\t" + str(v) for k, v in v_.items())
+            elif k_ == 'unk' and isinstance(v_, int):
+                attr_data[k_] = str(v_)
+            else:
+                attr_data[k_] = v_
+        return attr_data
+
+
 class BlingFireSentenceBreaker(CustomOp):
 
     @classmethod
@@ -449,11 +492,101 @@ class AudioDecoder(CustomOp):
         ]
 
 
+class BatchAudioDecoder(CustomOp):
+    @classmethod
+    def get_inputs(cls):
+        return [
+            cls.io_def('audio_bytes', onnx_proto.TensorProto.UINT8, [None]),
+            cls.io_def('row_splits', onnx_proto.TensorProto.INT64, [None])
+        ]
+
+    @classmethod
+    def get_outputs(cls):
+        return [
+            cls.io_def('floatPCM', onnx_proto.TensorProto.FLOAT, [None, None]),
+            cls.io_def('lengths', onnx_proto.TensorProto.INT64, [None])
+        ]
+
+
+class BatchAudioDecoderFromStrings(CustomOp):
+    @classmethod
+    def get_inputs(cls):
+        return [
+            cls.io_def('audio_clips', onnx_proto.TensorProto.STRING, [None])
+        ]
+
+    @classmethod
+    def get_outputs(cls):
+        return [
+            cls.io_def('floatPCM', onnx_proto.TensorProto.FLOAT, [None, None]),
+            cls.io_def('lengths', onnx_proto.TensorProto.INT64, [None])
+        ]
+
+
+class StreamingAudioDecoder(CustomOp):
+    @classmethod
+    def get_inputs(cls):
+        return [
+            cls.io_def('audio_chunk', onnx_proto.TensorProto.UINT8, [None]),
+            cls.io_def('state', onnx_proto.TensorProto.UINT8, [None]),
+            cls.io_def('end_of_stream', onnx_proto.TensorProto.BOOL, [])
+        ]
+
+    @classmethod
+    def get_outputs(cls):
+        return [
+            cls.io_def('floatPCM', onnx_proto.TensorProto.FLOAT, [None, None]),
+            cls.io_def('new_state', onnx_proto.TensorProto.UINT8, [None])
+        ]
+
+
+class Resample(CustomOp):
+    @classmethod
+    def get_inputs(cls):
+        return [
+            cls.io_def('waveform', onnx_proto.TensorProto.FLOAT, [None, None])
+        ]
+
+    @classmethod
+    def get_outputs(cls):
+        return [
+            cls.io_def('resampled', onnx_proto.TensorProto.FLOAT, [None, None])
+        ]
+
+
+class LogMelSpectrogram(CustomOp):
+    @classmethod
+    def get_inputs(cls):
+        return [
+            cls.io_def('waveforms', onnx_proto.TensorProto.FLOAT, [None, None])
+        ]
+
+    @classmethod
+    def get_outputs(cls):
+        return [
+            cls.io_def('log_mel', onnx_proto.TensorProto.FLOAT, [None, None, None])
+        ]
+
+
+class SpeechSegmentExtraction(CustomOp):
+    @classmethod
+    def get_inputs(cls):
+        return [
+            cls.io_def('pcm', onnx_proto.TensorProto.FLOAT, [1, None])
+        ]
+
+    @classmethod
+    def get_outputs(cls):
+        return [
+            cls.io_def('position', onnx_proto.TensorProto.INT64, [None, 2])
+        ]
+
+
 class StftNorm(CustomOp):
     @classmethod
     def get_inputs(cls):
         return [
-            cls.io_def('pcm_wave', onnx_proto.TensorProto.FLOAT, [1, None]),
+            cls.io_def('pcm_wave', onnx_proto.TensorProto.FLOAT, [None, None]),
             cls.io_def('n_fft', onnx_proto.TensorProto.INT64, []),
             cls.io_def('hop_length', onnx_proto.TensorProto.INT64, []),
             cls.io_def('window', onnx_proto.TensorProto.FLOAT, [None]),
@@ -463,7 +596,7 @@ class StftNorm(CustomOp):
     @classmethod
     def get_outputs(cls):
         return [
-            cls.io_def('stft_norm', onnx_proto.TensorProto.FLOAT, [1, None, None])
+            cls.io_def('stft_norm', onnx_proto.TensorProto.FLOAT, [None, None, None])
         ]
 
 
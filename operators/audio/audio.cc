@@ -2,16 +2,29 @@
 // Licensed under the MIT License.
 
 #include "ocos.h"
+#include "resample.hpp"
+#include "log_mel_spectrogram.hpp"
+#include "speech_segment_extraction.hpp"
 #ifdef ENABLE_DR_LIBS
+#define DR_FLAC_IMPLEMENTATION
+#define DR_MP3_IMPLEMENTATION 1
+#define DR_WAV_IMPLEMENTATION
 #include "audio_decoder.hpp"
+#include "batch_audio_decoder.hpp"
+#include "streaming_audio_decoder.hpp"
 #endif  // ENABLE_DR_LIBS
 
 FxLoadCustomOpFactory LoadCustomOpClasses_Audio = []()-> CustomOpArray& {
   static OrtOpLoader op_loader(
-    []() { return nullptr; }
+    CustomCpuStructV2("Resample", Resample),
+    CustomCpuStructV2("LogMelSpectrogram", LogMelSpectrogram),
+    CustomCpuStructV2("SpeechSegmentExtraction", SpeechSegmentExtraction)
 #ifdef ENABLE_DR_LIBS
     ,
-    CustomCpuStructV2("AudioDecoder", AudioDecoder)
+    CustomCpuStructV2("AudioDecoder", AudioDecoder),
+    CustomCpuStructV2("BatchAudioDecoder", BatchAudioDecoder),
+    CustomCpuStructV2("BatchAudioDecoderFromStrings", BatchAudioDecoderFromStrings),
+    CustomCpuStructV2("StreamingAudioDecoder", StreamingAudioDecoder)
 #endif
   );
 
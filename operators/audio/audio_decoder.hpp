@@ -5,16 +5,15 @@
 
 #include "ocos.h"
 
-#include <list>
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <optional>
-#define DR_FLAC_IMPLEMENTATION
+#include <type_traits>
+// the dr_libs implementations are compiled in audio.cc.
 #include "dr_flac.h"
-#define DR_MP3_IMPLEMENTATION 1
 #define DR_MP3_FLOAT_OUTPUT 1
 #include "dr_mp3.h"
-#define DR_WAV_IMPLEMENTATION
 #include "dr_wav.h"
 
 #include <gsl/util>
@@ -22,17 +21,81 @@
 #include "string_utils.h"
 #include "string_tensor.h"
 #include "sampling.h"
+#include "channel_mixer.h"
+
+// The channel attributes of the audio decoders. stereo_to_mono averages the channels of a stream into one,
+// selected_channels mixes only these channels, and channel_weights weighs the mixed channels, one weight per selected
+// channel, or per channel of the stream without selected_channels. Either of them mixes like stereo_to_mono.
+struct ChannelMixing {
+  OrtStatusPtr OnModelAttach(const OrtKernelInfo& info, const char* op_name) {
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "stereo_to_mono", stereo_mixer_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "selected_channels", selected_channels_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "channel_weights", channel_weights_));
+    if (std::any_of(selected_channels_.begin(), selected_channels_.end(), [](int64_t c) { return c < 0; })) {
+      return OrtW::CreateStatus(MakeString(op_name, ": selected_channels cannot be negative."), ORT_INVALID_ARGUMENT);
+    }
+    if (!selected_channels_.empty() && !channel_weights_.empty() &&
+        selected_channels_.size() != channel_weights_.size()) {
+      return OrtW::CreateStatus(MakeString(op_name, ": channel_weights needs one weight per selected channel."),
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    return nullptr;
+  }
+
+  bool IsEnabled() const {
+    return stereo_mixer_ != 0 || !selected_channels_.empty() || !channel_weights_.empty();
+  }
+
+  // The mixer of a stream of channels channels, none when its frames are output as they are.
+  OrtStatusPtr MakeMixer(size_t channels, const char* op_name, std::optional<ChannelMixer>& mixer) const {
+    mixer.reset();
+    if (!IsEnabled()) {
+      return nullptr;
+    }
+
+    std::vector<float> weights(channels, 0.0f);
+    if (!selected_channels_.empty()) {
+      for (size_t i = 0; i < selected_channels_.size(); ++i) {
+        const auto c = static_cast<size_t>(selected_channels_[i]);
+        if (c >= channels) {
+          return OrtW::CreateStatus(MakeString(op_name, ": cannot select the channel ", c, " of a ", channels,
+                                               "-channel stream."),
+                                    ORT_INVALID_ARGUMENT);
+        }
+        weights[c] += channel_weights_.empty() ? 1.0f / static_cast<float>(selected_channels_.size())
+                                               : channel_weights_[i];
+      }
+    } else if (!channel_weights_.empty()) {
+      if (channel_weights_.size() != channels) {
+        return OrtW::CreateStatus(MakeString(op_name, ": channel_weights has ", channel_weights_.size(),
+                                             " weights for a ", channels, "-channel stream."),
+                                  ORT_INVALID_ARGUMENT);
+      }
+      weights = channel_weights_;
+    } else {
+      weights = ChannelMixer::Average(channels).Weights();
+    }
+
+    // a mono stream is already mixed.
+    if (channels > 1 || (channels == 1 && weights[0] != 1.0f)) {
+      mixer.emplace(std::move(weights));
+    }
+    return nullptr;
+  }
+
+ private:
+  int64_t stereo_mixer_{};
+  std::vector<int64_t> selected_channels_;
+  std::vector<float> channel_weights_;
+};
 
 struct AudioDecoder{
  public:
 
   OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
-    auto status = OrtW::GetOpAttribute(info, "downsampling_rate", downsample_rate_);
-    if (!status) {
-      status = OrtW::GetOpAttribute(info, "stereo_to_mono", stereo_mixer_);
-    }
-
-    return status;
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "downsampling_rate", downsample_rate_));
+    return channel_mixing_.OnModelAttach(info, "[AudioDecoder]");
   }
 
   enum class AudioStreamType {
@@ -42,7 +105,8 @@ struct AudioDecoder{
     kFLAC
   };
 
-  AudioStreamType ReadStreamFormat(const uint8_t* p_data, const std::string& str_format, OrtStatusPtr& status) const {
+  AudioStreamType ReadStreamFormat(const uint8_t* p_data, size_t size, const std::string& str_format,
+                                   OrtStatusPtr& status) const {
     static const std::map<std::string, AudioStreamType> format_mapping = {
         {"default", AudioStreamType::kDefault},
         {"wav", AudioStreamType::kWAV},
@@ -62,7 +126,9 @@ struct AudioDecoder{
       stream_format = pos->second;
     }
 
-    if (stream_format == AudioStreamType::kDefault) {
+    if (stream_format == AudioStreamType::kDefault && size < 4) {
+      status = OrtW::CreateStatus("[AudioDecoder]: Cannot detect audio stream format", ORT_INVALID_ARGUMENT);
+    } else if (stream_format == AudioStreamType::kDefault) {
       auto p_stream = reinterpret_cast<char const*>(p_data);
       std::string_view marker(p_stream, 4);
       if (marker == "fLaC") {
@@ -81,126 +147,205 @@ struct AudioDecoder{
     return stream_format;
   }
 
-  template <typename TY_AUDIO, typename FX_DECODER>
-  static size_t DrReadFrames(std::list<std::vector<float>>& frames, FX_DECODER fx, TY_AUDIO& obj) {
-    const size_t default_chunk_size = 1024 * 256;
-    int64_t total_buf_size = 0;
+  OrtStatusPtr CheckSampleRate(int64_t orig_sample_rate) const {
+    if (downsample_rate_ != 0 &&
+        orig_sample_rate < downsample_rate_) {
+      return OrtW::CreateStatus("[AudioDecoder]: only down-sampling supported.", ORT_INVALID_ARGUMENT);
+    }
+    if (downsample_rate_ != 0 &&
+        orig_sample_rate > PolyphaseResampler::kMaxDownRatio * downsample_rate_) {
+      return OrtW::CreateStatus(MakeString("[AudioDecoder]: cannot down-sample by more than ",
+                                           PolyphaseResampler::kMaxDownRatio, " times.")
+                                    .c_str(),
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    return nullptr;
+  }
+
+  // Decodes the whole stream into pcm. total_frames, the length the decoder reads from the header (0 if unknown), is
+  // only a hint: a crafted header may claim far more frames than the stream holds, so the first allocation is
+  // bounded by what encoded_size bytes could plausibly decode to, and pcm grows as the frames are decoded. With a
+  // mixer, the stream is decoded a chunk at a time into samples of type T, and each chunk is mixed down to mono as it
+  // is converted to float, so pcm never holds the interleaved signal. The decoder reads 16-bit samples only to be
+  // mixed.
+  template <typename T, typename TY_AUDIO, typename FX_DECODER>
+  static void DrReadFrames(std::vector<float>& pcm, FX_DECODER fx, TY_AUDIO& obj, uint64_t total_frames,
+                           size_t encoded_size, const ChannelMixer* mixer) {
+    const uint64_t default_chunk_size = 1024 * 256;
+    const uint64_t mix_chunk_size = 4096;
+    // a low bit-rate MP3 decodes to about 16 frames per byte, and the lossless codecs to less.
+    const uint64_t frames_per_byte_hint = 16;
+    const size_t channels = obj.channels;
+    const size_t out_channels = mixer ? 1 : channels;
+    std::vector<T> interleaved(mixer ? mix_chunk_size * channels : 0);
 
+    const uint64_t plausible_frames = static_cast<uint64_t>(encoded_size) * frames_per_byte_hint / std::max<size_t>(channels, 1);
+    uint64_t capacity = total_frames != 0 ? std::min(total_frames, plausible_frames) : 0;
+    uint64_t n_frames = 0;
+    pcm.resize(capacity * out_channels);
     for (;;) {
-      std::vector<float> buf;
-      buf.resize(default_chunk_size * obj.channels);
-      auto n_frames = fx(&obj, default_chunk_size, buf.data());
-      if (n_frames <= 0) {
+      if (n_frames == capacity) {
+        if (total_frames != 0 && n_frames >= total_frames) {
+          break;
+        }
+        // grow geometrically, as far as the frames the header claims.
+        capacity += std::max(capacity, default_chunk_size);
+        if (total_frames != 0) {
+          capacity = std::min(capacity, total_frames);
+        }
+        pcm.resize(capacity * out_channels);
+      }
+
+      float* dest = pcm.data() + n_frames * out_channels;
+      uint64_t n_read = 0;
+      if (mixer) {
+        n_read = fx(&obj, std::min(capacity - n_frames, mix_chunk_size), interleaved.data());
+        mixer->Process(interleaved.data(), static_cast<size_t>(n_read), dest);
+      } else if constexpr (std::is_same_v<T, float>) {
+        n_read = fx(&obj, capacity - n_frames, dest);
+      }
+      if (n_read == 0) {
         break;
       }
-      auto data_size = n_frames * obj.channels;
-      total_buf_size += data_size;
-      buf.resize(data_size);
-      frames.emplace_back(std::move(buf));
+      n_frames += n_read;
     }
 
-    return total_buf_size;
+    pcm.resize(n_frames * out_channels);
   }
 
-    OrtStatusPtr Compute(const ortc::Tensor<uint8_t>& input,
-               const std::optional<std::string> format,
-               ortc::Tensor<float>& output0) const {
-    const uint8_t* p_data = input.Data();
-    auto input_dim = input.Shape();
+  // Decodes the stream [p_data, p_data + size) into pcm, mixed down to mono with the channel attributes, and returns
+  // its sample rate in orig_sample_rate.
+  OrtStatusPtr DecodeStream(const uint8_t* p_data, size_t size, const std::string& str_format,
+                            std::vector<float>& pcm, int64_t& orig_sample_rate) const {
     OrtStatusPtr status = nullptr;
-    if (!((input_dim.size() == 1) || (input_dim.size() == 2 && input_dim[0] == 1))) {
-      status = OrtW::CreateStatus("[AudioDecoder]: Expect input dimension [n] or [1,n].", ORT_INVALID_ARGUMENT);
-      return status;
-    }
-
-    std::string str_format;
-    if (format) {
-      str_format = *format;
-    }
-    auto stream_format = ReadStreamFormat(p_data, str_format, status);
+    auto stream_format = ReadStreamFormat(p_data, size, str_format, status);
     if (status) {
       return status;
     }
 
-    int64_t total_buf_size = 0;
-    std::list<std::vector<float>> lst_frames;
-    int64_t orig_sample_rate = 0;
-    int64_t orig_channels = 0;
+    std::optional<ChannelMixer> mixer;
+    const ChannelMixer* p_mixer = nullptr;
+    auto prepare = [&](auto& obj) {
+      orig_sample_rate = obj.sampleRate;
+      status = CheckSampleRate(orig_sample_rate);
+      if (!status) {
+        status = channel_mixing_.MakeMixer(obj.channels, "[AudioDecoder]", mixer);
+      }
+      const bool resampled = downsample_rate_ != 0 && downsample_rate_ != orig_sample_rate;
+      if (!status && !mixer && obj.channels > 1 && resampled) {
+        status = OrtW::CreateStatus(
+            "[AudioDecoder]: resampling needs the channels mixed, with stereo_to_mono, selected_channels or "
+            "channel_weights.",
+            ORT_INVALID_ARGUMENT);
+      }
+      p_mixer = mixer ? &*mixer : nullptr;
+      return status == nullptr;
+    };
 
     if (stream_format == AudioStreamType::kMP3) {
       auto mp3_obj_ptr = std::make_unique<drmp3>();
-      if (!drmp3_init_memory(mp3_obj_ptr.get(), p_data, input.NumberOfElement(), nullptr)) {
+      if (!drmp3_init_memory(mp3_obj_ptr.get(), p_data, size, nullptr)) {
         status = OrtW::CreateStatus("[AudioDecoder]: unexpected error on MP3 stream.", ORT_RUNTIME_EXCEPTION);
         return status;
       }
-      orig_sample_rate = mp3_obj_ptr->sampleRate;
-      orig_channels = mp3_obj_ptr->channels;
-      total_buf_size = DrReadFrames(lst_frames, drmp3_read_pcm_frames_f32, *mp3_obj_ptr);
+      auto mp3_obj_closer = gsl::finally([&mp3_obj_ptr]() { drmp3_uninit(mp3_obj_ptr.get()); });
+      if (prepare(*mp3_obj_ptr)) {
+        // only the frame headers are parsed to count the frames, then the decoder seeks back to the start.
+        DrReadFrames<float>(pcm, drmp3_read_pcm_frames_f32, *mp3_obj_ptr,
+                            drmp3_get_pcm_frame_count(mp3_obj_ptr.get()), size, p_mixer);
+      }
 
     } else if (stream_format == AudioStreamType::kFLAC) {
-      drflac* flac_obj = drflac_open_memory(p_data, input.NumberOfElement(), nullptr);
+      drflac* flac_obj = drflac_open_memory(p_data, size, nullptr);
       auto flac_obj_closer = gsl::finally([flac_obj]() { drflac_close(flac_obj); });
       if (flac_obj == nullptr) {
         status = OrtW::CreateStatus("[AudioDecoder]: unexpected error on FLAC stream.", ORT_RUNTIME_EXCEPTION);
         return status;
       }
-      orig_sample_rate = flac_obj->sampleRate;
-      orig_channels = flac_obj->channels;
-      total_buf_size = DrReadFrames(lst_frames, drflac_read_pcm_frames_f32, *flac_obj);
+      if (prepare(*flac_obj)) {
+        if (p_mixer && flac_obj->bitsPerSample <= 16) {
+          DrReadFrames<int16_t>(pcm, drflac_read_pcm_frames_s16, *flac_obj, flac_obj->totalPCMFrameCount, size,
+                                p_mixer);
+        } else {
+          DrReadFrames<float>(pcm, drflac_read_pcm_frames_f32, *flac_obj, flac_obj->totalPCMFrameCount, size,
+                              p_mixer);
+        }
+      }
 
     } else {
       drwav wav_obj;
-      if (!drwav_init_memory(&wav_obj, p_data, input.NumberOfElement(), nullptr)) {
+      if (!drwav_init_memory(&wav_obj, p_data, size, nullptr)) {
         status = OrtW::CreateStatus("[AudioDecoder]: unexpected error on WAV stream.", ORT_RUNTIME_EXCEPTION);
         return status;
       }
-      orig_sample_rate = wav_obj.sampleRate;
-      orig_channels = wav_obj.channels;
-      total_buf_size = DrReadFrames(lst_frames, drwav_read_pcm_frames_f32, wav_obj);
+      auto wav_obj_closer = gsl::finally([&wav_obj]() { drwav_uninit(&wav_obj); });
+      if (prepare(wav_obj)) {
+        if (p_mixer && wav_obj.translatedFormatTag == DR_WAVE_FORMAT_PCM && wav_obj.bitsPerSample == 16) {
+          DrReadFrames<int16_t>(pcm, drwav_read_pcm_frames_s16, wav_obj, wav_obj.totalPCMFrameCount, size,
+                                p_mixer);
+        } else {
+          DrReadFrames<float>(pcm, drwav_read_pcm_frames_f32, wav_obj, wav_obj.totalPCMFrameCount, size,
+                              p_mixer);
+        }
+      }
     }
 
-    if (downsample_rate_ != 0 &&
-        orig_sample_rate < downsample_rate_) {
-      status = OrtW::CreateStatus("[AudioDecoder]: only down-sampling supported.", ORT_INVALID_ARGUMENT);
+    return status;
+  }
+
+  // Number of the output samples of a decoded stream of length samples at orig_sample_rate.
+  size_t OutputLength(size_t length, int64_t orig_sample_rate) const {
+    if (downsample_rate_ == 0 || downsample_rate_ == orig_sample_rate) {
+      return length;
+    }
+    return PolyphaseResampler(orig_sample_rate, downsample_rate_).OutputLength(length);
+  }
+
+  // Writes the OutputLength(pcm.size(), orig_sample_rate) output samples of the decoded pcm to output.
+  void WriteOutput(const std::vector<float>& pcm, int64_t orig_sample_rate, float* output) const {
+    if (downsample_rate_ == 0 || downsample_rate_ == orig_sample_rate) {
+      std::copy(pcm.begin(), pcm.end(), output);
+      return;
+    }
+
+    // A lowpass filter on the audio data to remove high frequency noise, applied by the resampler as it reads the
+    // samples.
+    ButterworthLowpass filter(0.5 * downsample_rate_, 1.0 * orig_sample_rate);
+    PolyphaseResampler(orig_sample_rate, downsample_rate_).Process(pcm.data(), pcm.size(), filter, output);
+  }
+
+  OrtStatusPtr Compute(const ortc::Tensor<uint8_t>& input,
+               const std::optional<std::string> format,
+               ortc::Tensor<float>& output0) const {
+    const uint8_t* p_data = input.Data();
+    auto input_dim = input.Shape();
+    OrtStatusPtr status = nullptr;
+    if (!((input_dim.size() == 1) || (input_dim.size() == 2 && input_dim[0] == 1))) {
+      status = OrtW::CreateStatus("[AudioDecoder]: Expect input dimension [n] or [1,n].", ORT_INVALID_ARGUMENT);
       return status;
     }
 
-    // join all frames
-    std::vector<float> buf;
-    buf.resize(total_buf_size);
-    int64_t offset = 0;
-    for (auto& _b : lst_frames) {
-      std::copy(_b.begin(), _b.end(), buf.begin() + offset);
-      offset += _b.size();
+    std::string str_format;
+    if (format) {
+      str_format = *format;
     }
 
-    // mix the stereo channels into mono channel
-    if (stereo_mixer_ && orig_channels > 1) {
-      if (buf.size() > 1) {
-        for (size_t i = 0; i < buf.size() / 2; ++i) {
-          buf[i] = (buf[i * 2] + buf[i * 2 + 1]) / 2;
-        }
-        buf.resize(buf.size() / 2);
-      }
+    std::vector<float> pcm;
+    int64_t orig_sample_rate = 0;
+    status = DecodeStream(p_data, static_cast<size_t>(input.NumberOfElement()), str_format, pcm, orig_sample_rate);
+    if (status) {
+      return status;
     }
 
-    if (downsample_rate_ != 0 &&
-        downsample_rate_ != orig_sample_rate) {
-      // A lowpass filter on buf audio data to remove high frequency noise
-      ButterworthLowpass filter(0.5 * downsample_rate_, 1.0 * orig_sample_rate);
-      std::vector<float> filtered_buf = filter.Process(buf);
-      // downsample the audio data
-      KaiserWindowInterpolation::Process(filtered_buf, buf,
-                                         1.0f * orig_sample_rate, 1.0f * downsample_rate_);
-    }
-
-    std::vector<int64_t> dim_out = {1, ort_extensions::narrow<int64_t>(buf.size())};
-    float* p_output = output0.Allocate(dim_out);
-    std::copy(buf.begin(), buf.end(), p_output);
+    // the output shape is only known once the stream is decoded, as the headers may overstate a truncated stream.
+    const size_t output_length = OutputLength(pcm.size(), orig_sample_rate);
+    float* p_output = output0.Allocate({1, ort_extensions::narrow<int64_t>(output_length)});
+    WriteOutput(pcm, orig_sample_rate, p_output);
     return status;
   }
 
  private:
   int64_t downsample_rate_{};
-  int64_t stereo_mixer_{};
+  ChannelMixing channel_mixing_;
 };
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "audio_decoder.hpp"
+#include "thread_pool.h"
+
+#include <exception>
+
+// Decodes a batch of encoded audio clips, each one like AudioDecoder with the same attributes, into the zero-padded
+// PCM [B, T] of the longest clip and the lengths [B] of the rows. The clips are decoded, mixed down and resampled
+// concurrently on the thread pool, and the resampler writes straight into the rows of the output.
+struct BatchAudioDecoder {
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+    return decoder_.OnModelAttach(api, info);
+  }
+
+  // The clip i is audio_bytes[row_splits[i], row_splits[i + 1]).
+  OrtStatusPtr Compute(const ortc::Tensor<uint8_t>& audio_bytes,
+                       const ortc::Tensor<int64_t>& row_splits,
+                       ortc::Tensor<float>& pcm,
+                       ortc::Tensor<int64_t>& lengths) const {
+    const int64_t num_bytes = audio_bytes.NumberOfElement();
+    const int64_t* splits = row_splits.Data();
+    const auto num_splits = static_cast<size_t>(row_splits.NumberOfElement());
+    if (row_splits.Shape().size() != 1 || num_splits == 0 || splits[0] != 0 || splits[num_splits - 1] != num_bytes) {
+      return OrtW::CreateStatus("[BatchAudioDecoder]: row_splits must go from 0 to the number of the bytes.",
+                                ORT_INVALID_ARGUMENT);
+    }
+    for (size_t i = 1; i < num_splits; ++i) {
+      if (splits[i] < splits[i - 1]) {
+        return OrtW::CreateStatus("[BatchAudioDecoder]: row_splits must be non-decreasing.", ORT_INVALID_ARGUMENT);
+      }
+    }
+
+    const uint8_t* p_bytes = audio_bytes.Data();
+    return DecodeClips(
+        num_splits - 1,
+        [&](size_t i) {
+          return std::make_pair(p_bytes + splits[i], static_cast<size_t>(splits[i + 1] - splits[i]));
+        },
+        pcm, lengths);
+  }
+
+ protected:
+  // clip(i) returns the pointer and the size of the encoded clip i.
+  template <typename FX_CLIP>
+  OrtStatusPtr DecodeClips(size_t num_clips, FX_CLIP clip, ortc::Tensor<float>& pcm,
+                           ortc::Tensor<int64_t>& lengths) const {
+    std::vector<std::vector<float>> decoded(num_clips);
+    std::vector<int64_t> sample_rates(num_clips);
+    std::vector<OrtStatusPtr> statuses(num_clips);
+    ort_extensions::ParallelFor(num_clips, 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const auto [data, size] = clip(i);
+#ifndef OCOS_NO_EXCEPTIONS
+        // an allocation failing on one clip becomes its status, and the other clips still decode.
+        try {
+          statuses[i] = decoder_.DecodeStream(data, size, std::string(), decoded[i], sample_rates[i]);
+        } catch (const std::exception& e) {
+          decoded[i] = std::vector<float>();
+          statuses[i] = OrtW::CreateStatus(MakeString("[BatchAudioDecoder]: clip ", i, ": ", e.what()),
+                                           ORT_RUNTIME_EXCEPTION);
+        }
+#else
+        statuses[i] = decoder_.DecodeStream(data, size, std::string(), decoded[i], sample_rates[i]);
+#endif
+      }
+    });
+
+    // the first error is reported, the others released.
+    OrtStatusPtr status = nullptr;
+    for (OrtStatusPtr& clip_status : statuses) {
+      if (clip_status == nullptr) {
+        continue;
+      }
+      if (status == nullptr) {
+        status = clip_status;
+      } else {
+        OrtW::ReleaseStatus(clip_status);
+      }
+    }
+    if (status) {
+      return status;
+    }
+
+    int64_t* p_lengths = lengths.Allocate({static_cast<int64_t>(num_clips)});
+    size_t max_length = 0;
+    for (size_t i = 0; i < num_clips; ++i) {
+      const size_t length = decoder_.OutputLength(decoded[i].size(), sample_rates[i]);
+      p_lengths[i] = ort_extensions::narrow<int64_t>(length);
+      max_length = std::max(max_length, length);
+    }
+
+    float* p_pcm = pcm.Allocate({static_cast<int64_t>(num_clips), ort_extensions::narrow<int64_t>(max_length)});
+    ort_extensions::ParallelFor(num_clips, 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        float* row = p_pcm + i * max_length;
+        decoder_.WriteOutput(decoded[i], sample_rates[i], row);
+        std::fill(row + p_lengths[i], row + max_length, 0.0f);
+        std::vector<float>().swap(decoded[i]);
+      }
+    });
+
+    return nullptr;
+  }
+
+  AudioDecoder decoder_;
+};
+
+// BatchAudioDecoder over a string tensor, one encoded clip per element.
+struct BatchAudioDecoderFromStrings : BatchAudioDecoder {
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& clips,
+                       ortc::Tensor<float>& pcm,
+                       ortc::Tensor<int64_t>& lengths) const {
+    const auto& views = clips.Data();
+    return DecodeClips(
+        views.size(),
+        [&](size_t i) {
+          return std::make_pair(reinterpret_cast<const uint8_t*>(views[i].data()), views[i].size());
+        },
+        pcm, lengths);
+  }
+};
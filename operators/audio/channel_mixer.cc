@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "channel_mixer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCOS_MIXER_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCOS_MIXER_NEON
+#endif
+
+namespace {
+
+// the 16-bit samples are scaled like drwav_s16_to_f32.
+constexpr float kInt16Scale = 1.0f / 32768.0f;
+
+inline float Value(float v) { return v; }
+inline float Value(int16_t v) { return static_cast<float>(v); }
+
+// The lanes hold one channel of four consecutive frames. AVX2 gains nothing over 4 lanes, as the shuffles of the
+// de-interleaving cost more than the arithmetic.
+#if defined(OCOS_MIXER_SSE2)
+using Lanes = __m128;
+inline Lanes Broadcast(float v) { return _mm_set1_ps(v); }
+inline Lanes MulAdd(Lanes acc, Lanes w, Lanes x) { return _mm_add_ps(acc, _mm_mul_ps(w, x)); }
+inline void Store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+inline Lanes Set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+
+inline Lanes ToFloat(__m128i v) { return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)); }
+inline Lanes Load4(const float* p) { return _mm_loadu_ps(p); }
+inline Lanes Load4(const int16_t* p) { return ToFloat(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))); }
+
+// p[0], p[1], q[0], q[1].
+inline Lanes Load2x2(const float* p, const float* q) {
+  return _mm_movelh_ps(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))),
+                       _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q))));
+}
+inline Lanes Load2x2(const int16_t* p, const int16_t* q) {
+  int32_t a, b;
+  std::memcpy(&a, p, sizeof(a));
+  std::memcpy(&b, q, sizeof(b));
+  return ToFloat(_mm_unpacklo_epi32(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b)));
+}
+
+// the even and the odd lanes of a, then of b.
+inline void Deinterleave2(Lanes a, Lanes b, Lanes& even, Lanes& odd) {
+  even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+inline void Transpose4(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+
+#elif defined(OCOS_MIXER_NEON)
+using Lanes = float32x4_t;
+inline Lanes Broadcast(float v) { return vdupq_n_f32(v); }
+inline Lanes MulAdd(Lanes acc, Lanes w, Lanes x) { return vaddq_f32(acc, vmulq_f32(w, x)); }
+inline void Store(float* p, Lanes v) { vst1q_f32(p, v); }
+inline Lanes Set(float a, float b, float c, float d) {
+  const float v[4] = {a, b, c, d};
+  return vld1q_f32(v);
+}
+
+inline Lanes Load4(const float* p) { return vld1q_f32(p); }
+inline Lanes Load4(const int16_t* p) { return vcvtq_f32_s32(vmovl_s16(vld1_s16(p))); }
+
+inline Lanes Load2x2(const float* p, const float* q) { return vcombine_f32(vld1_f32(p), vld1_f32(q)); }
+inline Lanes Load2x2(const int16_t* p, const int16_t* q) {
+  const int16_t v[4] = {p[0], p[1], q[0], q[1]};
+  return Load4(v);
+}
+
+inline void Deinterleave2(Lanes a, Lanes b, Lanes& even, Lanes& odd) {
+  const float32x4x2_t v = vuzpq_f32(a, b);
+  even = v.val[0];
+  odd = v.val[1];
+}
+
+inline void Transpose4(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3) {
+  const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+  const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+  r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+  r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+  r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+  r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+#endif
+
+// Mixes the channels [first, last) of the frames with the weights w[first, last). The channels of four frames are
+// de-interleaved into lanes four, two or one at a time.
+template <typename T>
+void Mix(const T* input, size_t num_frames, size_t channels, const float* w, size_t first, size_t last,
+         float* output) {
+  size_t i = 0;
+#if defined(OCOS_MIXER_SSE2) || defined(OCOS_MIXER_NEON)
+  const size_t n = channels;
+  for (; i + 4 <= num_frames; i += 4) {
+    const T* f0 = input + i * n;
+    const T* f1 = f0 + n;
+    const T* f2 = f1 + n;
+    const T* f3 = f2 + n;
+    Lanes acc = Broadcast(0.0f);
+    size_t c = first;
+    for (; c + 4 <= last; c += 4) {
+      Lanes r0 = Load4(f0 + c);
+      Lanes r1 = Load4(f1 + c);
+      Lanes r2 = Load4(f2 + c);
+      Lanes r3 = Load4(f3 + c);
+      Transpose4(r0, r1, r2, r3);
+      acc = MulAdd(acc, Broadcast(w[c]), r0);
+      acc = MulAdd(acc, Broadcast(w[c + 1]), r1);
+      acc = MulAdd(acc, Broadcast(w[c + 2]), r2);
+      acc = MulAdd(acc, Broadcast(w[c + 3]), r3);
+    }
+    if (c + 2 <= last) {
+      Lanes even, odd;
+      Deinterleave2(Load2x2(f0 + c, f1 + c), Load2x2(f2 + c, f3 + c), even, odd);
+      acc = MulAdd(acc, Broadcast(w[c]), even);
+      acc = MulAdd(acc, Broadcast(w[c + 1]), odd);
+      c += 2;
+    }
+    if (c < last) {
+      acc = MulAdd(acc, Broadcast(w[c]), Set(Value(f0[c]), Value(f1[c]), Value(f2[c]), Value(f3[c])));
+    }
+    Store(output + i, acc);
+  }
+#endif
+  for (; i < num_frames; ++i) {
+    const T* frame = input + i * channels;
+    float sum = 0.0f;
+    for (size_t c = first; c < last; ++c) {
+      sum += w[c] * Value(frame[c]);
+    }
+    output[i] = sum;
+  }
+}
+
+// The channels [first, last) with a weight, the others are skipped.
+template <typename T>
+void MixWeighted(const T* input, size_t num_frames, const std::vector<float>& weights, float* output) {
+  const auto is_used = [](float w) { return w != 0.0f; };
+  const auto first = static_cast<size_t>(std::find_if(weights.begin(), weights.end(), is_used) - weights.begin());
+  const auto last = static_cast<size_t>(weights.rend() - std::find_if(weights.rbegin(), weights.rend(), is_used));
+  if (first >= last) {
+    std::fill(output, output + num_frames, 0.0f);
+    return;
+  }
+  Mix(input, num_frames, weights.size(), weights.data(), first, last, output);
+}
+
+}  // namespace
+
+void ChannelMixer::Process(const float* input, size_t num_frames, float* output) const {
+  MixWeighted(input, num_frames, weights_, output);
+}
+
+void ChannelMixer::Process(const int16_t* input, size_t num_frames, float* output) const {
+  std::vector<float> scaled(weights_);
+  for (float& w : scaled) {
+    w *= kInt16Scale;
+  }
+  MixWeighted(input, num_frames, scaled, output);
+}
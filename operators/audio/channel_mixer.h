@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Mixes the interleaved frames of a multi-channel stream into one sample per frame, the weighted sum of its
+// channels. Selecting a channel is mixing with its weight 1 and the others 0. The frames are de-interleaved four at a
+// time on SSE2 or NEON vectors, for any number of channels, and 16-bit samples are converted to float in the same
+// pass, so the decoders can mix their integer output without a float copy of the interleaved signal.
+class ChannelMixer {
+ public:
+  // weights[c] multiplies the channel c of the frames, weights.size() channels.
+  explicit ChannelMixer(std::vector<float> weights) : weights_(std::move(weights)) {}
+
+  // The average of all the channels.
+  static ChannelMixer Average(size_t channels) {
+    return ChannelMixer(std::vector<float>(channels, 1.0f / static_cast<float>(channels)));
+  }
+
+  size_t Channels() const { return weights_.size(); }
+  const std::vector<float>& Weights() const { return weights_; }
+
+  // output[i] = sum of weights[c] * input[i * Channels() + c], the channels added in order. output may be input, as
+  // the frames are read before their samples are written.
+  void Process(const float* input, size_t num_frames, float* output) const;
+  // The same for the 16-bit samples of the decoders, scaled to [-1, 1) like drwav_s16_to_f32.
+  void Process(const int16_t* input, size_t num_frames, float* output) const;
+
+ private:
+  std::vector<float> weights_;
+};
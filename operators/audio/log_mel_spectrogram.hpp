@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ocos.h"
+#include "fft.h"
+#include "thread_pool.h"
+
+// Log-mel spectrogram of a batch of waveforms [B, T] as [B, n_mels, T / hop_length], the Whisper features:
+// the power spectrum of centered frames of n_fft samples under a periodic Hann window, with the waveform reflected
+// at its ends, through a Slaney mel filterbank, then log10 of the energies clamped to 1e-10. Like the Whisper
+// preprocessing, the frame centered on the last sample is dropped. With a positive dynamic_range, the values of each
+// waveform are raised to at least its maximum minus dynamic_range (8 for Whisper), and with whisper_normalize the
+// values are then mapped to (x + 4) / 4 like the Whisper feature extractor. The WhisperPrePipeline of _torch_cvt.py
+// keeps StftNorm: it floors the whole batch at once and pads the features to 30 seconds with the floor.
+struct LogMelSpectrogram {
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "n_fft", n_fft_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "hop_length", hop_length_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "n_mels", n_mels_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "sample_rate", sample_rate_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "dynamic_range", dynamic_range_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "whisper_normalize", whisper_normalize_));
+    if (n_fft_ <= 0 || hop_length_ <= 0 || n_mels_ <= 0 || sample_rate_ <= 0) {
+      return OrtW::CreateStatus("[LogMelSpectrogram]: n_fft, hop_length, n_mels and sample_rate must be positive.",
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    std::vector<float> window(static_cast<size_t>(n_fft_));
+    for (size_t i = 0; i < window.size(); ++i) {
+      window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(i) / n_fft_));
+    }
+    spectrum_ = std::make_shared<ort_extensions::FramePowerSpectrum>(std::move(window));
+    BuildFilterbank();
+    return nullptr;
+  }
+
+  OrtStatusPtr Compute(const ortc::Tensor<float>& input, ortc::Tensor<float>& output) const {
+    const std::vector<int64_t>& dims = input.Shape();
+    if (dims.size() != 2) {
+      return OrtW::CreateStatus("[LogMelSpectrogram]: the input must be a [batch, samples] tensor.",
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    const auto batch = static_cast<size_t>(dims[0]);
+    const auto length = static_cast<int64_t>(dims[1]);
+    const auto frames = static_cast<size_t>(length / hop_length_);
+    if (frames > 0 && length <= n_fft_ / 2) {
+      return OrtW::CreateStatus("[LogMelSpectrogram]: the waveforms must be longer than n_fft / 2 samples.",
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    const auto n_mels = static_cast<size_t>(n_mels_);
+    float* p_output = output.Allocate({dims[0], n_mels_, static_cast<int64_t>(frames)});
+    const float* p_input = input.Data();
+
+    ort_extensions::ParallelFor(batch * frames, kFrameGrain, [&](size_t begin, size_t end) {
+      auto workspace = spectrum_->MakeWorkspace();
+      std::vector<float> power(spectrum_->NumBins());
+      for (size_t i = begin; i < end; ++i) {
+        const size_t b = i / frames;
+        const size_t f = i % frames;
+        spectrum_->Compute(p_input + b * static_cast<size_t>(length), length, static_cast<int64_t>(f) * hop_length_,
+                           power.data(), workspace);
+
+        float* column = p_output + b * n_mels * frames + f;
+        for (size_t m = 0; m < n_mels; ++m) {
+          const float* weights = mel_weights_.data() + mel_offsets_[m];
+          const float* bins = power.data() + mel_first_bins_[m];
+          const size_t count = mel_offsets_[m + 1] - mel_offsets_[m];
+          float energy = 0.0f;
+          for (size_t k = 0; k < count; ++k) {
+            energy += weights[k] * bins[k];
+          }
+          column[m * frames] = std::log10(std::max(energy, 1e-10f));
+        }
+      }
+    });
+
+    if (dynamic_range_ > 0.0f) {
+      const size_t per_item = n_mels * frames;
+      for (size_t b = 0; b < batch && per_item > 0; ++b) {
+        float* item = p_output + b * per_item;
+        const float floor = *std::max_element(item, item + per_item) - dynamic_range_;
+        std::transform(item, item + per_item, item, [floor](float v) { return std::max(v, floor); });
+      }
+    }
+    if (whisper_normalize_) {
+      const size_t size = batch * n_mels * frames;
+      std::transform(p_output, p_output + size, p_output, [](float v) { return (v + 4.0f) / 4.0f; });
+    }
+
+    return nullptr;
+  }
+
+ private:
+  // frames transformed by one task of the thread pool.
+  static constexpr size_t kFrameGrain = 16;
+
+  // The triangular filters of librosa's Slaney mel scale (linear below 1 kHz, logarithmic above) up to the Nyquist
+  // frequency, each normalized by its width; only the bins under each triangle are kept.
+  void BuildFilterbank() {
+    const size_t num_bins = spectrum_->NumBins();
+    const double linear_step = 200.0 / 3.0;
+    const double min_log_hz = 1000.0;
+    const double min_log_mel = min_log_hz / linear_step;
+    const double log_step = std::log(6.4) / 27.0;
+    auto hz_to_mel = [&](double hz) {
+      return hz < min_log_hz ? hz / linear_step : min_log_mel + std::log(hz / min_log_hz) / log_step;
+    };
+    auto mel_to_hz = [&](double mel) {
+      return mel < min_log_mel ? mel * linear_step : min_log_hz * std::exp(log_step * (mel - min_log_mel));
+    };
+
+    const auto n_mels = static_cast<size_t>(n_mels_);
+    const double max_mel = hz_to_mel(sample_rate_ / 2.0);
+    std::vector<double> edges(n_mels + 2);
+    for (size_t i = 0; i < edges.size(); ++i) {
+      edges[i] = mel_to_hz(max_mel * static_cast<double>(i) / static_cast<double>(n_mels + 1));
+    }
+
+    mel_first_bins_.assign(n_mels, 0);
+    mel_offsets_.assign(1, 0);
+    mel_weights_.clear();
+    for (size_t m = 0; m < n_mels; ++m) {
+      const double norm = 2.0 / (edges[m + 2] - edges[m]);
+      size_t first = num_bins;
+      size_t last = 0;
+      std::vector<float> weights(num_bins);
+      for (size_t k = 0; k < num_bins; ++k) {
+        const double hz = static_cast<double>(k) * sample_rate_ / static_cast<double>(n_fft_);
+        const double rising = (hz - edges[m]) / (edges[m + 1] - edges[m]);
+        const double falling = (edges[m + 2] - hz) / (edges[m + 2] - edges[m + 1]);
+        weights[k] = static_cast<float>(std::max(0.0, std::min(rising, falling)) * norm);
+        if (weights[k] > 0.0f) {
+          first = std::min(first, k);
+          last = k;
+        }
+      }
+
+      if (first <= last) {
+        mel_first_bins_[m] = first;
+        mel_weights_.insert(mel_weights_.end(), weights.begin() + first, weights.begin() + last + 1);
+      }
+      mel_offsets_.push_back(mel_weights_.size());
+    }
+  }
+
+  int64_t n_fft_{400};
+  int64_t hop_length_{160};
+  int64_t n_mels_{80};
+  int64_t sample_rate_{16000};
+  float dynamic_range_{};
+  int64_t whisper_normalize_{};
+
+  // the frames under a periodic Hann window of n_fft samples.
+  std::shared_ptr<ort_extensions::FramePowerSpectrum> spectrum_;
+  // the weights of the mel m are mel_weights_[mel_offsets_[m], mel_offsets_[m + 1]), from the bin mel_first_bins_[m].
+  std::vector<size_t> mel_first_bins_;
+  std::vector<size_t> mel_offsets_;
+  std::vector<float> mel_weights_;
+};
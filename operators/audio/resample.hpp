@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ocos.h"
+#include "string_utils.h"
+#include "sampling.h"
+
+// Resamples the last axis of a float tensor from orig_sample_rate to target_sample_rate.
+struct Resample {
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "orig_sample_rate", orig_sample_rate_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "target_sample_rate", target_sample_rate_));
+    if (orig_sample_rate_ <= 0 || target_sample_rate_ <= 0) {
+      return OrtW::CreateStatus("[Resample]: the sample rates must be positive.", ORT_INVALID_ARGUMENT);
+    }
+    if (orig_sample_rate_ > PolyphaseResampler::kMaxDownRatio * target_sample_rate_) {
+      return OrtW::CreateStatus(MakeString("[Resample]: cannot down-sample by more than ",
+                                           PolyphaseResampler::kMaxDownRatio, " times."),
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    resampler_ = std::make_shared<PolyphaseResampler>(orig_sample_rate_, target_sample_rate_);
+    return nullptr;
+  }
+
+  OrtStatusPtr Compute(const ortc::Tensor<float>& input, ortc::Tensor<float>& output) const {
+    std::vector<int64_t> dims = input.Shape();
+    if (dims.empty()) {
+      return OrtW::CreateStatus("[Resample]: the input must have at least one dimension.", ORT_INVALID_ARGUMENT);
+    }
+
+    const auto length = static_cast<size_t>(dims.back());
+    const size_t rows = length == 0 ? 0 : static_cast<size_t>(input.NumberOfElement()) / length;
+    const size_t output_length = resampler_->OutputLength(length);
+    dims.back() = static_cast<int64_t>(output_length);
+    float* p_output = output.Allocate(dims);
+    const float* p_input = input.Data();
+    for (size_t row = 0; row < rows; ++row) {
+      resampler_->Process(p_input + row * length, length, p_output + row * output_length);
+    }
+
+    return nullptr;
+  }
+
+ private:
+  int64_t orig_sample_rate_{};
+  int64_t target_sample_rate_{};
+  std::shared_ptr<PolyphaseResampler> resampler_;
+};
@@ -0,0 +1,461 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "sampling.h"
+
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include "thread_pool.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OCOS_SAMPLING_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCOS_SAMPLING_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCOS_SAMPLING_NEON
+#endif
+
+namespace {
+
+// The filter parameters of the kaiser_fast mode of resampy: 16 zero crossings of the sinc on each side, a Kaiser
+// window with beta 8.555 and a cutoff at 85% of the lower Nyquist frequency.
+constexpr double kZeroCrossings = 16.0;
+constexpr double kKaiserBeta = 8.555;
+constexpr double kRolloff = 0.85;
+
+// the fractional positions are rounded to 1/kMaxPhases of an input sample when the reduced up factor is larger.
+constexpr int64_t kMaxPhases = 1024;
+
+// the taps of every phase are padded with zeros to a multiple of the widest vector.
+constexpr size_t kTapAlign = 8;
+
+// output samples computed by one task of the thread pool.
+constexpr size_t kResampleGrain = 4096;
+
+// the lowpass filter has forgotten its initial delay elements once their contribution falls below this.
+constexpr double kWarmUpTolerance = 1e-10;
+
+// the samples of every lane filtered between the gathers and scatters of ProcessLanes.
+constexpr size_t kLaneBlock = 64;
+
+// std::cyl_bessel_i is not available for every platform.
+double BesselI0(double x) {
+  double sum = 0.0;
+  double term = 1.0;
+  double x_squared = x * x / 4.0;
+  size_t n = 0;
+
+  while (term > 1e-12 * sum) {
+    sum += term;
+    n += 1;
+    term *= x_squared / static_cast<double>(n * n);
+  }
+
+  return sum;
+}
+
+// n is a multiple of kTapAlign.
+inline float DotProduct(const float* a, const float* b, size_t n) {
+#if defined(OCOS_SAMPLING_AVX2)
+  __m256 acc = _mm256_setzero_ps();
+  for (size_t i = 0; i < n; i += 8) {
+    acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  }
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+#elif defined(OCOS_SAMPLING_SSE2)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (size_t i = 0; i < n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  __m128 sum = _mm_add_ps(acc0, acc1);
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+#elif defined(OCOS_SAMPLING_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (size_t i = 0; i < n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  return vaddvq_f32(vaddq_f32(acc0, acc1));
+#else
+  float sum[4] = {};
+  for (size_t i = 0; i < n; i += 4) {
+    sum[0] += a[i] * b[i];
+    sum[1] += a[i + 1] * b[i + 1];
+    sum[2] += a[i + 2] * b[i + 2];
+    sum[3] += a[i + 3] * b[i + 3];
+  }
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+#endif
+}
+
+// The lanes of the lowpass filter. Its gathers and scatters of the segments cost more than the recursion, so AVX2
+// gains nothing over 4 lanes.
+#if defined(OCOS_SAMPLING_AVX2) || defined(OCOS_SAMPLING_SSE2)
+using Lanes = __m128;
+constexpr size_t kNumLanes = 4;
+inline Lanes Broadcast(float v) { return _mm_set1_ps(v); }
+inline Lanes Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes Sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+#elif defined(OCOS_SAMPLING_NEON)
+using Lanes = float32x4_t;
+constexpr size_t kNumLanes = 4;
+inline Lanes Broadcast(float v) { return vdupq_n_f32(v); }
+inline Lanes Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, Lanes v) { vst1q_f32(p, v); }
+inline Lanes Add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+inline Lanes Sub(Lanes a, Lanes b) { return vsubq_f32(a, b); }
+inline Lanes Mul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+#else
+constexpr size_t kNumLanes = 1;
+#endif
+
+// the lowpass filter runs on this many vectors of lanes at once, each lane filtering a segment of the signal.
+constexpr size_t kLaneGroups = kNumLanes > 1 ? 2 : 1;
+constexpr size_t kNumSegments = kNumLanes * kLaneGroups;
+
+#if defined(OCOS_SAMPLING_AVX2) || defined(OCOS_SAMPLING_SSE2) || defined(OCOS_SAMPLING_NEON)
+// ButterworthLowpass::Section broadcast to every lane.
+struct LaneSection {
+  Lanes b0, b1, b2, a1, a2;
+
+  static LaneSection From(const ButterworthLowpass::Section& s) {
+    return {Broadcast(s.b0), Broadcast(s.b1), Broadcast(s.b2), Broadcast(s.a1), Broadcast(s.a2)};
+  }
+
+  // One sample of every lane through the section with the delay elements z1 and z2.
+  Lanes Filter(Lanes x, Lanes& z1, Lanes& z2) const {
+    const Lanes y = Add(Mul(b0, x), z1);
+    z1 = Sub(Add(Mul(b1, x), z2), Mul(a1, y));
+    z2 = Sub(Mul(b2, x), Mul(a2, y));
+    return y;
+  }
+};
+#endif
+
+// The largest magnitude of the roots of z^2 + a1 z + a2, the poles of a section.
+double PoleRadius(double a1, double a2) {
+  const double discriminant = a1 * a1 - 4.0 * a2;
+  if (discriminant < 0.0) {
+    return std::sqrt(a2);
+  }
+  const double root = std::sqrt(discriminant);
+  return std::max(std::abs(-a1 + root), std::abs(-a1 - root)) / 2.0;
+}
+
+}  // namespace
+
+ButterworthLowpass::ButterworthLowpass(double cutoff_freq, double sampling_rate) {
+  auto normalized_cutoff = cutoff_freq / sampling_rate;
+  CalculateCoefs(coefs_b_, coefs_a_, kFilterOrder, normalized_cutoff);
+
+  double radius = 0.0;
+  for (size_t p = 0; p < kNumSections; ++p) {
+    double a[3]{}, b[3]{};
+    OnePoleCoefs(static_cast<double>(p + 1), kFilterOrder, normalized_cutoff, a, b);
+    // OnePoleCoefs gives the feedback coefficients with the opposite sign.
+    const double gain = (a[0] + a[1] + a[2]) / (1.0 - b[1] - b[2]);
+    sections_[p] = {static_cast<float>(a[0] / gain), static_cast<float>(a[1] / gain), static_cast<float>(a[2] / gain),
+                    static_cast<float>(-b[1]), static_cast<float>(-b[2])};
+    radius = std::max(radius, PoleRadius(-b[1], -b[2]));
+  }
+
+  warm_up_ = std::numeric_limits<size_t>::max();
+  if (radius < 1.0) {
+    const double length = std::ceil(std::log(kWarmUpTolerance) / std::log(radius));
+    if (length < static_cast<double>(std::numeric_limits<uint32_t>::max())) {
+      warm_up_ = static_cast<size_t>(length);
+    }
+  }
+}
+
+void ButterworthLowpass::Process(float* data, size_t n, History& history) const {
+  const size_t segment = n / kNumSegments;
+  if (kNumSegments > 1 && segment / 4 >= warm_up_) {
+    ProcessLanes(data, segment, history);
+    data += kNumSegments * segment;
+    n -= kNumSegments * segment;
+  }
+  ProcessSerial(data, n, history);
+}
+
+void ButterworthLowpass::ProcessSerial(float* data, size_t n, History& history) const {
+  // the sections and their delay elements are kept in registers.
+  static_assert(kNumSections == 2, "ProcessSerial runs the two sections of the 4th order filter");
+  const Section c = sections_[0];
+  const Section d = sections_[1];
+  float c1 = history[0], c2 = history[1], d1 = history[2], d2 = history[3];
+  for (size_t i = 0; i < n; ++i) {
+    const float x = data[i];
+    const float u = c.b0 * x + c1;
+    c1 = (c.b1 * x + c2) - c.a1 * u;
+    c2 = c.b2 * x - c.a2 * u;
+    const float y = d.b0 * u + d1;
+    d1 = (d.b1 * u + d2) - d.a1 * y;
+    d2 = d.b2 * u - d.a2 * y;
+    data[i] = y;
+  }
+  history = {c1, c2, d1, d2};
+}
+
+// Filters the kNumSegments segments data[j * segment, (j + 1) * segment) side by side, two vectors of lanes at a
+// time to hide the latency of the recursion, on blocks of kLaneBlock samples of every segment gathered
+// with the samples of the segments interleaved. The segment j > 0 starts from the delay elements of the warm_up_
+// samples before it, which the segment j - 1 only reaches later as segment >= 4 * warm_up_, and the delay elements
+// of the last segment are left in history.
+void ButterworthLowpass::ProcessLanes(float* data, size_t segment, History& history) const {
+#if defined(OCOS_SAMPLING_AVX2) || defined(OCOS_SAMPLING_SSE2) || defined(OCOS_SAMPLING_NEON)
+  static_assert(kNumSections == 2 && kLaneGroups == 2, "ProcessLanes runs two sections on two vectors of lanes");
+  const LaneSection c = LaneSection::From(sections_[0]);
+  const LaneSection d = LaneSection::From(sections_[1]);
+  // the delay elements of the two sections for the two vectors of lanes.
+  Lanes c1[2] = {Broadcast(0.0f), Broadcast(0.0f)}, c2[2] = {Broadcast(0.0f), Broadcast(0.0f)};
+  Lanes d1[2] = {Broadcast(0.0f), Broadcast(0.0f)}, d2[2] = {Broadcast(0.0f), Broadcast(0.0f)};
+
+  float block[kLaneBlock * kNumSegments];
+  auto filter_block = [&](size_t steps) {
+    for (size_t t = 0; t < steps; ++t) {
+      float* samples = block + t * kNumSegments;
+      const Lanes u0 = c.Filter(Load(samples), c1[0], c2[0]);
+      const Lanes u1 = c.Filter(Load(samples + kNumLanes), c1[1], c2[1]);
+      Store(samples, d.Filter(u0, d1[0], d2[0]));
+      Store(samples + kNumLanes, d.Filter(u1, d1[1], d2[1]));
+    }
+  };
+
+  // the first segment has no samples before it and runs on zeros, its delay elements are set afterwards.
+  for (size_t t0 = 0; t0 < warm_up_; t0 += kLaneBlock) {
+    const size_t steps = std::min(kLaneBlock, warm_up_ - t0);
+    for (size_t t = 0; t < steps; ++t) {
+      block[t * kNumSegments] = 0.0f;
+      for (size_t j = 1; j < kNumSegments; ++j) {
+        block[t * kNumSegments + j] = data[j * segment - warm_up_ + t0 + t];
+      }
+    }
+    filter_block(steps);
+  }
+
+  float lanes[kNumLanes];
+  auto set_first_lane = [&lanes](Lanes& z, float value) {
+    Store(lanes, z);
+    lanes[0] = value;
+    z = Load(lanes);
+  };
+  set_first_lane(c1[0], history[0]);
+  set_first_lane(c2[0], history[1]);
+  set_first_lane(d1[0], history[2]);
+  set_first_lane(d2[0], history[3]);
+
+  for (size_t t0 = 0; t0 < segment; t0 += kLaneBlock) {
+    const size_t steps = std::min(kLaneBlock, segment - t0);
+    for (size_t j = 0; j < kNumSegments; ++j) {
+      const float* src = data + j * segment + t0;
+      for (size_t t = 0; t < steps; ++t) {
+        block[t * kNumSegments + j] = src[t];
+      }
+    }
+    filter_block(steps);
+    for (size_t j = 0; j < kNumSegments; ++j) {
+      float* dst = data + j * segment + t0;
+      for (size_t t = 0; t < steps; ++t) {
+        dst[t] = block[t * kNumSegments + j];
+      }
+    }
+  }
+
+  auto last_lane = [&lanes](Lanes z) {
+    Store(lanes, z);
+    return lanes[kNumLanes - 1];
+  };
+  history = {last_lane(c1[1]), last_lane(c2[1]), last_lane(d1[1]), last_lane(d2[1])};
+#else
+  ProcessSerial(data, kNumSegments * segment, history);
+#endif
+}
+
+struct PolyphaseResampler::FilterBank {
+  int64_t up;
+  int64_t down;
+  int64_t num_phases{};
+  // number of taps of a phase, and the index of the input sample under the first tap relative to the one at or
+  // before the output position.
+  size_t taps{};
+  int64_t first_tap{};
+  // num_phases rows of taps coefficients, the row q being the filter for the fractional position q / num_phases.
+  std::vector<float> coefs;
+
+  FilterBank(int64_t up_factor, int64_t down_factor) : up(up_factor), down(down_factor) {
+    num_phases = std::min(up, kMaxPhases);
+    if (up == down) {
+      return;
+    }
+
+    // the cutoff, relative to the input Nyquist frequency, is below the output one when down-sampling.
+    const double cutoff = kRolloff * std::min(1.0, static_cast<double>(up) / static_cast<double>(down));
+    const int64_t half = static_cast<int64_t>(std::ceil(kZeroCrossings / cutoff));
+    taps = (static_cast<size_t>(2 * half) + kTapAlign - 1) / kTapAlign * kTapAlign;
+    first_tap = 1 - half;
+    coefs.assign(static_cast<size_t>(num_phases) * taps, 0.0f);
+
+    const double i0_beta = BesselI0(kKaiserBeta);
+    std::vector<double> phase(taps);
+    for (int64_t q = 0; q < num_phases; ++q) {
+      const double frac = static_cast<double>(q) / static_cast<double>(num_phases);
+      double sum = 0.0;
+      for (int64_t k = 0; k < 2 * half; ++k) {
+        const double distance = static_cast<double>(first_tap + k) - frac;
+        const double x = distance / static_cast<double>(half);
+        const double window = x * x < 1.0 ? BesselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) / i0_beta : 0.0;
+        const double arg = M_PI * cutoff * distance;
+        const double sinc = std::abs(arg) < 1e-9 ? 1.0 : std::sin(arg) / arg;
+        phase[k] = cutoff * sinc * window;
+        sum += phase[k];
+      }
+
+      // every phase passes a constant signal unchanged.
+      float* row = coefs.data() + q * taps;
+      for (int64_t k = 0; k < 2 * half; ++k) {
+        row[k] = static_cast<float>(phase[k] / sum);
+      }
+    }
+  }
+};
+
+PolyphaseResampler::PolyphaseResampler(int64_t input_rate, int64_t output_rate) {
+  static std::mutex mutex;
+  static std::map<std::pair<int64_t, int64_t>, std::shared_ptr<const FilterBank>> banks;
+
+  const int64_t divisor = std::gcd(input_rate, output_rate);
+  const std::pair<int64_t, int64_t> ratio{output_rate / divisor, input_rate / divisor};
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& bank = banks[ratio];
+  if (!bank) {
+    bank = std::make_shared<const FilterBank>(ratio.first, ratio.second);
+  }
+  bank_ = bank;
+}
+
+size_t PolyphaseResampler::OutputLength(size_t input_length) const {
+  const auto up = static_cast<uint64_t>(bank_->up);
+  const auto down = static_cast<uint64_t>(bank_->down);
+  return static_cast<size_t>((static_cast<uint64_t>(input_length) * up + down - 1) / down);
+}
+
+void PolyphaseResampler::Process(const float* input, size_t input_length, float* output) const {
+  Process(input, 0, input_length, 0, OutputLength(input_length), output);
+}
+
+int64_t PolyphaseResampler::FirstInput(uint64_t output_index) const {
+  const auto up = static_cast<uint64_t>(bank_->up);
+  const auto down = static_cast<uint64_t>(bank_->down);
+  // the phase may round up to the next input sample, which only moves the first tap one sample later.
+  return static_cast<int64_t>(output_index * down / up) + bank_->first_tap;
+}
+
+uint64_t PolyphaseResampler::ReadyOutputs(int64_t input_end) const {
+  const auto up = static_cast<uint64_t>(bank_->up);
+  const auto down = static_cast<uint64_t>(bank_->down);
+  if (up == down) {
+    return input_end < 0 ? 0 : static_cast<uint64_t>(input_end);
+  }
+
+  // the outputs whose base sample floor(i * down / up) is at most last_base, allowing for the phase rounding up.
+  const int64_t last_base = input_end - static_cast<int64_t>(bank_->taps) - bank_->first_tap - 1;
+  if (last_base < 0) {
+    return 0;
+  }
+  return ((static_cast<uint64_t>(last_base) + 1) * up - 1) / down + 1;
+}
+
+void PolyphaseResampler::Process(const float* input, int64_t input_begin, size_t input_length,
+                                 uint64_t output_begin, uint64_t output_end, float* output) const {
+  const FilterBank& bank = *bank_;
+  const auto length = static_cast<int64_t>(input_length);
+  if (bank.up == bank.down) {
+    for (uint64_t i = output_begin; i < output_end; ++i) {
+      const int64_t k = static_cast<int64_t>(i) - input_begin;
+      output[i - output_begin] = k >= 0 && k < length ? input[k] : 0.0f;
+    }
+    return;
+  }
+
+  const auto up = static_cast<uint64_t>(bank.up);
+  const auto down = static_cast<uint64_t>(bank.down);
+  const auto num_phases = static_cast<uint64_t>(bank.num_phases);
+  const auto taps = static_cast<int64_t>(bank.taps);
+  const auto output_length = static_cast<size_t>(output_end - output_begin);
+  ort_extensions::ParallelFor(output_length, kResampleGrain, [&](size_t begin, size_t end) {
+    // the output sample i sits at the input position i * down / up, split into base + rem / up.
+    const uint64_t first = output_begin + begin;
+    uint64_t base = first * down / up;
+    uint64_t rem = first * down % up;
+    for (size_t i = begin; i < end; ++i) {
+      int64_t start = static_cast<int64_t>(base) + bank.first_tap - input_begin;
+      uint64_t q = (rem * num_phases + up / 2) / up;
+      if (q == num_phases) {
+        q = 0;
+        ++start;
+      }
+
+      const float* row = bank.coefs.data() + q * bank.taps;
+      if (start >= 0 && start + taps <= length) {
+        output[i] = DotProduct(input + start, row, bank.taps);
+      } else {
+        // near the ends, only the taps over the input contribute.
+        const int64_t k_begin = std::max<int64_t>(0, -start);
+        const int64_t k_end = std::min<int64_t>(taps, length - start);
+        float sum = 0.0f;
+        for (int64_t k = k_begin; k < k_end; ++k) {
+          sum += input[start + k] * row[k];
+        }
+        output[i] = sum;
+      }
+
+      base += down / up;
+      rem += down % up;
+      if (rem >= up) {
+        rem -= up;
+        ++base;
+      }
+    }
+  });
+}
+
+void PolyphaseResampler::Process(const float* input, size_t input_length, const ButterworthLowpass& lowpass,
+                                 float* output) const {
+  const size_t output_length = OutputLength(input_length);
+  const size_t warm_up = lowpass.WarmUpLength();
+  if (warm_up >= input_length) {
+    std::vector<float> filtered(input, input + input_length);
+    lowpass.Process(filtered.data(), filtered.size());
+    Process(filtered.data(), 0, filtered.size(), 0, output_length, output);
+    return;
+  }
+
+  const auto length = static_cast<int64_t>(input_length);
+  const auto taps = static_cast<int64_t>(bank_->taps);
+  ort_extensions::ParallelFor(output_length, kResampleGrain, [&](size_t begin, size_t end) {
+    // the input samples under the taps of the outputs [begin, end), and the ones before them that settle the filter.
+    const int64_t first = std::clamp<int64_t>(FirstInput(begin), 0, length);
+    const int64_t last = std::clamp<int64_t>(FirstInput(end - 1) + taps + 1, first, length);
+    const int64_t from = std::max<int64_t>(0, first - static_cast<int64_t>(warm_up));
+    std::vector<float> filtered(input + from, input + last);
+    lowpass.Process(filtered.data(), filtered.size());
+    Process(filtered.data() + (first - from), first, static_cast<size_t>(last - first), begin, end, output + begin);
+  });
+}
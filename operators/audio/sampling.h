@@ -7,6 +7,9 @@
 #include <cmath>
 #include <complex>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
 #include "narrow.h"
 
 #ifndef M_PI
@@ -106,125 +109,104 @@ class ButterworthLowpass {
   std::vector<double> coefs_b_;
 
  public:
-  ButterworthLowpass(double cutoff_freq, double sampling_rate) {
-    auto normalized_cutoff = cutoff_freq / sampling_rate;
-    CalculateCoefs(coefs_b_, coefs_a_, kFilterOrder, normalized_cutoff);
-  }
+  static constexpr size_t kNumSections = kFilterOrder / 2;
+
+  // A second-order section in the transposed direct form II,
+  // y[n] = b0 x[n] + b1 x[n - 1] + b2 x[n - 2] - a1 y[n - 1] - a2 y[n - 2], with a unit gain at DC.
+  struct Section {
+    float b0, b1, b2, a1, a2;
+  };
+
+  // The two delay elements of each section.
+  using History = std::array<float, 2 * kNumSections>;
+
+  ButterworthLowpass(double cutoff_freq, double sampling_rate);
 
-  const std::vector<double>& GetCoefs_A() {
+  // The coefficients of the whole filter in the direct form.
+  const std::vector<double>& GetCoefs_A() const {
     return coefs_a_;
   }
 
-  const std::vector<double>& GetCoefs_B() {
+  const std::vector<double>& GetCoefs_B() const {
     return coefs_b_;
   }
 
-  std::vector<float> Process(const std::vector<float>& input) {
-    std::vector<float> output(input.size(), 0.0);
-
-    // Initialize delay elements
-    double x_n_1 = 0.0, x_n_2 = 0.0, x_n_3 = 0.0, x_n_4 = 0.0;
-    double y_n_1 = 0.0, y_n_2 = 0.0, y_n_3 = 0.0, y_n_4 = 0.0;
+  // The filter runs as this cascade of one section per pair of poles.
+  const std::array<Section, kNumSections>& GetSections() const {
+    return sections_;
+  }
 
-    for (size_t i = 0; i < input.size(); ++i) {
-      double x = input[i];
+  // The number of samples after which the output no longer depends on the initial delay elements, to float
+  // precision; the maximum of size_t for a filter that does not forget them.
+  size_t WarmUpLength() const {
+    return warm_up_;
+  }
 
-      // Compute the output
-      double y = coefs_b_[0] * x + coefs_b_[1] * x_n_1 + coefs_b_[2] * x_n_2 + coefs_b_[3] * x_n_3 + coefs_b_[4] * x_n_4
-        - coefs_a_[1] * y_n_1 - coefs_a_[2] * y_n_2 - coefs_a_[3] * y_n_3 - coefs_a_[4] * y_n_4;
+  std::vector<float> Process(const std::vector<float>& input) const {
+    std::vector<float> output(input);
+    Process(output.data(), output.size());
+    return output;
+  }
 
-      // Shuffle old input and output values
-      x_n_4 = x_n_3;
-      x_n_3 = x_n_2;
-      x_n_2 = x_n_1;
-      x_n_1 = x;
+  // Filters data[0, n) in place.
+  void Process(float* data, size_t n) const {
+    History history{};
+    Process(data, n, history);
+  }
 
-      y_n_4 = y_n_3;
-      y_n_3 = y_n_2;
-      y_n_2 = y_n_1;
-      y_n_1 = y;
+  // Filters data[0, n) in place as the continuation of the signal whose delay elements are in history, and updates
+  // them, so that a signal can be filtered a chunk at a time.
+  // A long enough signal is split into one segment per SIMD lane, filtered side by side: each segment but the first
+  // starts from the delay elements left by the WarmUpLength() samples before it.
+  void Process(float* data, size_t n, History& history) const;
 
-      output[i] = static_cast<float>(y);
-    }
+ private:
+  void ProcessSerial(float* data, size_t n, History& history) const;
+  void ProcessLanes(float* data, size_t segment, History& history) const;
 
-    return output;
-  }
+  std::array<Section, kNumSections> sections_{};
+  size_t warm_up_{};
 };
 
-// https://ccrma.stanford.edu/~jos/sasp/Kaiser_Window.html
-class KaiserWindowInterpolation {
- private:
-  // Kaiser window parameters, empirically
-  static constexpr double kBeta = 6.0;  // Beta controls the width of the transition band
-
+// Rational-ratio resampler. The output rate over the input rate is reduced to up/down, and each output sample is the
+// dot product of the input around its position with one phase of a Kaiser-windowed sinc lowpass filter.
+// The filter banks are computed once per ratio and shared by all the resamplers of the process, so Process only
+// reads the coefficients and allocates nothing.
+// https://ccrma.stanford.edu/~jos/resample/
+class PolyphaseResampler {
  public:
-  static void Process(const std::vector<float>& input, std::vector<float>& output, float inputSampleRate, float outputSampleRate) {
-    // Downsampling factor
-    float factor = outputSampleRate / inputSampleRate;
-
-    // Calculate the number of output samples
-    int outputSize = static_cast<int>(std::ceil(static_cast<float>(input.size()) * factor));
-    output.resize(outputSize);
-
-    for (size_t i = 0; i < outputSize; i++) {
-      float index = i / factor;  // Fractional index for interpolation
-
-      // Calculate the integer and fractional parts of the index
-      int integerPart = static_cast<int>(index);
-      float fractionalPart = index - integerPart;
-
-      // Calculate the range of input samples for interpolation
-      int range = static_cast<int>(std::ceil(kBeta / (2.0 * factor)));
-      size_t startSample = std::max(0, integerPart - range);
-      size_t endSample = std::min(static_cast<int>(input.size()) - 1, integerPart + range);
-
-      // Calculate the Kaiser window weights for the input samples
-      std::vector<double> weights = KaiserWin(static_cast<size_t>(endSample - startSample + 1));
-      for (size_t j = startSample; j <= endSample; j++) {
-        double distance = std::abs(static_cast<double>(j) - index);
-        double sincValue = (distance < 1e-6f) ? 1.0f : std::sin(M_PI * distance) / (M_PI * distance);
-        weights[j - startSample] *= sincValue;
-      }
+  // the largest input rate over output rate supported, the filter length grows linearly with it.
+  static constexpr int64_t kMaxDownRatio = 256;
 
-      // Perform the interpolation
-      double interpolatedValue = 0.0f;
-      for (size_t j = startSample; j <= endSample; j++) {
-        interpolatedValue += input[j] * weights[j - startSample];
-      }
+  struct FilterBank;
 
-      output[i] = static_cast<float>(interpolatedValue);
-    }
-  }
+  // Both rates must be positive, with input_rate <= kMaxDownRatio * output_rate.
+  PolyphaseResampler(int64_t input_rate, int64_t output_rate);
 
- private:
-  // std::cyl_bessel_i is not available for every platform.
-  static double cyl_bessel_i0(double x) {
-    double sum = 0.0;
-    double term = 1.0;
-    double x_squared = x * x / 4.0;
-    size_t n = 0;
-    double tolerance = 1e-8;
-
-    while (term > tolerance * sum) {
-      sum += term;
-      n += 1;
-      term *= x_squared / (n * n);
-    }
+  // ceil(input_length * output_rate / input_rate)
+  size_t OutputLength(size_t input_length) const;
 
-    return sum;
-  }
+  // Resamples input[0, input_length) into output[0, OutputLength(input_length)), the signal being zero outside
+  // the input. The output samples are computed in parallel.
+  void Process(const float* input, size_t input_length, float* output) const;
 
-  // Kaiser Window function
-  static std::vector<double> KaiserWin(size_t window_length) {
-    std::vector<double> window(window_length);
-    static const double i0_beta = cyl_bessel_i0(kBeta);
+  // To resample a signal a chunk at a time: input holds the samples [input_begin, input_begin + input_length) of
+  // the signal, zero outside them, and the output samples [output_begin, output_end) are written to output.
+  void Process(const float* input, int64_t input_begin, size_t input_length,
+               uint64_t output_begin, uint64_t output_end, float* output) const;
 
-    for (size_t i = 0; i < window_length; i++) {
-      double x = 2.0 * i / (window_length - 1.0) - 1.0;
-      double bessel_value = cyl_bessel_i0(kBeta * std::sqrt(1 - x * x));
-      window[i] = bessel_value / i0_beta;
-    }
+  // Resamples input[0, input_length) through the lowpass filter into output[0, OutputLength(input_length)), in one
+  // pass over the input that leaves it unchanged: the filter runs from a zero state at the start of the signal, and
+  // every task of the thread pool filters the input span of its output samples into a buffer of its own, from
+  // lowpass.WarmUpLength() samples earlier, right before resampling it.
+  void Process(const float* input, size_t input_length, const ButterworthLowpass& lowpass, float* output) const;
 
-    return window;
-  }
+  // The index of the first input sample that the output sample output_index depends on.
+  int64_t FirstInput(uint64_t output_index) const;
+
+  // The number of leading output samples that only depend on the input samples before input_end.
+  uint64_t ReadyOutputs(int64_t input_end) const;
+
+ private:
+  std::shared_ptr<const FilterBank> bank_;
 };
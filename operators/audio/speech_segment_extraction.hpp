@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ocos.h"
+#include "voice_activity.h"
+
+// The speech segments of the PCM of AudioDecoder, [n] or [1, n], as the [start, end) sample positions [N, 2] of a
+// VoiceActivityDetector with the attributes of its options. The positions index the PCM tensor itself, so that a
+// recognition loop can run the model on each segment in place.
+struct SpeechSegmentExtraction {
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+    VoiceActivityDetector::Options options;
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "frame_length", options.frame_length));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "energy_threshold", options.energy_threshold));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "zero_crossing_threshold", options.zero_crossing_threshold));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "min_speech_length", options.min_speech_length));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "min_silence_length", options.min_silence_length));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "padding", options.padding));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "max_segment_length", options.max_segment_length));
+    if (options.frame_length <= 0) {
+      return OrtW::CreateStatus("[SpeechSegmentExtraction]: frame_length must be positive.", ORT_INVALID_ARGUMENT);
+    }
+    if (options.min_speech_length < 0 || options.min_silence_length < 0 || options.padding < 0 ||
+        options.max_segment_length < 0) {
+      return OrtW::CreateStatus("[SpeechSegmentExtraction]: the lengths and the padding must not be negative.",
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    detector_ = std::make_shared<VoiceActivityDetector>(options);
+    return nullptr;
+  }
+
+  OrtStatusPtr Compute(const ortc::Tensor<float>& pcm, ortc::Tensor<int64_t>& position) const {
+    const std::vector<int64_t>& dims = pcm.Shape();
+    if (!((dims.size() == 1) || (dims.size() == 2 && dims[0] == 1))) {
+      return OrtW::CreateStatus("[SpeechSegmentExtraction]: Expect input dimension [n] or [1,n].",
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    const auto segments = detector_->Detect(pcm.Data(), static_cast<size_t>(pcm.NumberOfElement()));
+    int64_t* p_position = position.Allocate({static_cast<int64_t>(segments.size()), 2});
+    for (const auto& segment : segments) {
+      *p_position++ = segment.first;
+      *p_position++ = segment.second;
+    }
+
+    return nullptr;
+  }
+
+ private:
+  std::shared_ptr<VoiceActivityDetector> detector_;
+};
@@ -0,0 +1,500 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "audio_decoder.hpp"
+
+#include <climits>
+#include <cstring>
+
+// Decodes an audio stream that arrives as successive chunks of encoded bytes, for long recordings and live input.
+// Everything the next call needs travels in the state tensor: the bytes not decoded yet, the last MP3 frames to
+// rebuild the decoder from, the lowpass and resampler histories and the PCM samples not emitted yet. The PCM comes out in windows of
+// window_length samples, so the memory used stays bounded however long the stream is.
+// WAV and MP3 streams are supported; FLAC needs the whole stream, use AudioDecoder for it.
+struct StreamingAudioDecoder {
+ public:
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "downsampling_rate", downsample_rate_));
+    ORTX_RETURN_IF_ERROR(channel_mixing_.OnModelAttach(info, "[StreamingAudioDecoder]"));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "window_length", window_length_));
+    if (window_length_ < 0) {
+      return OrtW::CreateStatus("[StreamingAudioDecoder]: window_length cannot be negative.", ORT_INVALID_ARGUMENT);
+    }
+
+    return nullptr;
+  }
+
+  // chunk: the next encoded bytes of the stream, [n] or [1,n].
+  // state: the state returned by the previous call, empty for the first chunk of a stream.
+  // end_of_stream: flushes the filters and emits the last window, padded with zeros.
+  // pcm: [number of windows, window_length], or [1, n] with all the samples ready when window_length is 0.
+  OrtStatusPtr Compute(const ortc::Tensor<uint8_t>& chunk,
+                       const ortc::Tensor<uint8_t>& state,
+                       std::optional<bool> end_of_stream,
+                       ortc::Tensor<float>& pcm,
+                       ortc::Tensor<uint8_t>& new_state) const {
+    auto chunk_dim = chunk.Shape();
+    if (!((chunk_dim.size() == 1) || (chunk_dim.size() == 2 && chunk_dim[0] == 1))) {
+      return OrtW::CreateStatus("[StreamingAudioDecoder]: Expect chunk dimension [n] or [1,n].",
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    Stream stream;
+    if (state.NumberOfElement() > 0) {
+      if (!stream.Load(state.Data(), static_cast<size_t>(state.NumberOfElement()))) {
+        return OrtW::CreateStatus("[StreamingAudioDecoder]: invalid state.", ORT_INVALID_ARGUMENT);
+      }
+    }
+    const bool eos = end_of_stream.value_or(false);
+    const uint8_t* p_chunk = chunk.Data();
+    stream.bytes.insert(stream.bytes.end(), p_chunk, p_chunk + chunk.NumberOfElement());
+
+    std::vector<float> decoded;
+    ORTX_RETURN_IF_ERROR(Decode(stream, eos, decoded));
+    if (stream.bytes.size() > kMaxPendingBytes) {
+      return OrtW::CreateStatus("[StreamingAudioDecoder]: no audio frame found in the stream.",
+                                ORT_INVALID_ARGUMENT);
+    }
+    ORTX_RETURN_IF_ERROR(ProcessSamples(stream, eos, decoded));
+
+    // emit the complete windows, and at the end of the stream what is left padded to a window.
+    auto& pending = stream.pending;
+    size_t window = pending.size();
+    size_t num_windows = 1;
+    if (window_length_ > 0) {
+      window = static_cast<size_t>(window_length_);
+      num_windows = pending.size() / window + (eos && pending.size() % window != 0 ? 1 : 0);
+    }
+    const size_t num_samples = std::min(pending.size(), num_windows * window);
+    float* p_pcm = pcm.Allocate({static_cast<int64_t>(num_windows), static_cast<int64_t>(window)});
+    std::copy(pending.begin(), pending.begin() + num_samples, p_pcm);
+    std::fill(p_pcm + num_samples, p_pcm + num_windows * window, 0.0f);
+    pending.erase(pending.begin(), pending.begin() + num_samples);
+
+    stream.Save(new_state);
+    return nullptr;
+  }
+
+ private:
+  static constexpr uint32_t kStateMagic = 0x33445341;  // "ASD3"
+  // MP3 frames are only decoded with this many bytes ahead, so that minimp3 can find the frame sync reliably.
+  static constexpr size_t kMp3Lookahead = 16 * 1024;
+  // the bit reservoir of minimp3, the main data of the previous frames a frame may start in.
+  static constexpr size_t kMp3ReservoirBytes = 511;
+  // the most bytes of a frame that are not main data: the header, the CRC and the side information.
+  static constexpr size_t kMp3FrameOverhead = 4 + 2 + 32;
+  // the most bytes kept undecoded, the WAV header or the MP3 bytes before the first frame.
+  static constexpr size_t kMaxPendingBytes = 1024 * 1024;
+
+  // The fixed part of the state tensor, followed by the bytes, the resampler history and the pending PCM samples.
+  // The minimp3 decoder is not saved: a state tensor could set its reservoir offsets anywhere. The bytes start
+  // with the last MP3 frames decoded, and decoding them again into a new decoder restores its bit reservoir and
+  // overlap exactly, so the frames after them decode like one pass over the stream.
+  struct StreamState {
+    uint32_t magic;
+    uint32_t format;  // AudioDecoder::AudioStreamType, kDefault until the stream format is detected
+    int64_t sample_rate;
+    int64_t channels;
+    uint32_t wav_format_tag;  // 0 until the WAV header is read
+    uint32_t wav_bits_per_sample;
+    uint64_t wav_data_left;  // bytes of the WAV data chunk not decoded yet
+    uint64_t mp3_skip_bytes;    // bytes of the ID3 tag at the start of an MP3 stream not received yet
+    uint64_t mp3_replay_bytes;  // bytes of decoded MP3 frames at the start of the bytes, decoded again
+    ButterworthLowpass::History filter_history;
+    int64_t history_begin;  // index of the first resampler history sample in the decoded signal
+    uint64_t next_output;   // index of the next resampled sample
+    uint64_t num_bytes;
+    uint64_t num_history;
+    uint64_t num_pending;
+  };
+
+  struct Stream {
+    StreamState header{kStateMagic};
+    std::vector<uint8_t> bytes;
+    std::vector<float> history;
+    std::vector<float> pending;
+
+    bool IsMP3() const {
+      return header.format == static_cast<uint32_t>(AudioDecoder::AudioStreamType::kMP3);
+    }
+
+    size_t StateSize() const {
+      return sizeof(StreamState) + bytes.size() +
+             (history.size() + pending.size()) * sizeof(float);
+    }
+
+    bool Load(const uint8_t* data, size_t size) {
+      if (size < sizeof(StreamState)) {
+        return false;
+      }
+      std::memcpy(&header, data, sizeof(StreamState));
+      if (header.magic != kStateMagic || header.num_bytes > size || header.num_history > size ||
+          header.num_pending > size || !IsValidHeader()) {
+        return false;
+      }
+      bytes.resize(header.num_bytes);
+      history.resize(header.num_history);
+      pending.resize(header.num_pending);
+      if (StateSize() != size) {
+        return false;
+      }
+
+      data += sizeof(StreamState);
+      std::copy(data, data + bytes.size(), bytes.begin());
+      data += bytes.size();
+      std::memcpy(history.data(), data, history.size() * sizeof(float));
+      data += history.size() * sizeof(float);
+      std::memcpy(pending.data(), data, pending.size() * sizeof(float));
+      return true;
+    }
+
+    // The fields a state tensor could hold after a valid stream, the decoders divide by the channels and the bytes
+    // per frame.
+    bool IsValidHeader() const {
+      using AudioStreamType = AudioDecoder::AudioStreamType;
+      if (header.format != static_cast<uint32_t>(AudioStreamType::kDefault) &&
+          header.format != static_cast<uint32_t>(AudioStreamType::kWAV) && !IsMP3()) {
+        return false;
+      }
+      if (header.mp3_replay_bytes > header.num_bytes || (!IsMP3() && header.mp3_replay_bytes != 0)) {
+        return false;
+      }
+      // the stream format, the channels and the rate are known together, from the WAV header or the first MP3 frame.
+      if (header.sample_rate == 0) {
+        return header.channels == 0 && header.wav_format_tag == 0 && header.history_begin == 0 &&
+               header.next_output == 0;
+      }
+      const int64_t max_channels = IsMP3() ? 2 : UINT16_MAX;
+      if (header.sample_rate < 0 || header.sample_rate > UINT32_MAX || header.channels <= 0 ||
+          header.channels > max_channels || header.history_begin < 0) {
+        return false;
+      }
+      if (header.wav_format_tag != 0) {
+        return !IsMP3() && IsSupportedWavFormat(header.wav_format_tag, header.wav_bits_per_sample);
+      }
+      return true;
+    }
+
+    void Save(ortc::Tensor<uint8_t>& state) {
+      header.num_bytes = bytes.size();
+      header.num_history = history.size();
+      header.num_pending = pending.size();
+      uint8_t* data = state.Allocate({static_cast<int64_t>(StateSize())});
+      std::memcpy(data, &header, sizeof(StreamState));
+      data += sizeof(StreamState);
+      std::copy(bytes.begin(), bytes.end(), data);
+      data += bytes.size();
+      std::memcpy(data, history.data(), history.size() * sizeof(float));
+      data += history.size() * sizeof(float);
+      std::memcpy(data, pending.data(), pending.size() * sizeof(float));
+    }
+  };
+
+  static uint16_t ReadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+  }
+
+  static uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  // Reads the WAV header once the bytes up to the start of the data chunk are there, and drops them.
+  // PCM, IEEE float, A-law and mu-law, the formats DecodeWav converts.
+  static bool IsSupportedWavFormat(uint32_t format_tag, uint32_t bits) {
+    return (format_tag == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+           (format_tag == 3 && (bits == 32 || bits == 64)) || ((format_tag == 6 || format_tag == 7) && bits == 8);
+  }
+
+  static OrtStatusPtr ReadWavHeader(Stream& stream) {
+    const auto& bytes = stream.bytes;
+    StreamState& header = stream.header;
+    if (bytes.size() < 12) {
+      return nullptr;
+    }
+    if (std::memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+      return OrtW::CreateStatus("[StreamingAudioDecoder]: unexpected error on WAV stream.", ORT_INVALID_ARGUMENT);
+    }
+
+    uint32_t format_tag = 0;
+    for (size_t pos = 12; pos + 8 <= bytes.size();) {
+      const uint8_t* chunk = bytes.data() + pos;
+      const uint32_t size = ReadU32(chunk + 4);
+      if (std::memcmp(chunk, "data", 4) == 0) {
+        if (format_tag == 0) {
+          break;
+        }
+        header.wav_format_tag = format_tag;
+        // writers that cannot seek back leave the size of the data chunk unset.
+        header.wav_data_left = size == 0 || size == 0xFFFFFFFF ? UINT64_MAX : size;
+        stream.bytes.erase(stream.bytes.begin(), stream.bytes.begin() + pos + 8);
+        return nullptr;
+      }
+
+      if (pos + 8 + size > bytes.size()) {
+        break;
+      }
+      if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+        format_tag = ReadU16(chunk + 8);
+        header.channels = ReadU16(chunk + 10);
+        header.sample_rate = ReadU32(chunk + 12);
+        header.wav_bits_per_sample = ReadU16(chunk + 22);
+        if (format_tag == 0xFFFE && size >= 26) {
+          // WAVE_FORMAT_EXTENSIBLE, the format is in the first bytes of the sub-format GUID.
+          format_tag = ReadU16(chunk + 32);
+        }
+
+        const uint32_t bits = header.wav_bits_per_sample;
+        if (!IsSupportedWavFormat(format_tag, bits) || header.channels == 0 || header.sample_rate == 0) {
+          return OrtW::CreateStatus(MakeString("[StreamingAudioDecoder]: unsupported WAV format ", format_tag,
+                                               " with ", bits, " bits per sample.")
+                                        .c_str(),
+                                    ORT_INVALID_ARGUMENT);
+        }
+      }
+      pos += 8 + size + (size & 1);
+    }
+
+    return nullptr;
+  }
+
+  static void DecodeWav(Stream& stream, std::vector<float>& decoded) {
+    StreamState& header = stream.header;
+    const size_t sample_bytes = header.wav_bits_per_sample / 8;
+    const size_t frame_bytes = sample_bytes * static_cast<size_t>(header.channels);
+    const size_t available = static_cast<size_t>(std::min<uint64_t>(stream.bytes.size(), header.wav_data_left));
+    const size_t num_samples = available / frame_bytes * static_cast<size_t>(header.channels);
+    const uint8_t* p = stream.bytes.data();
+
+    decoded.resize(num_samples);
+    float* out = decoded.data();
+    switch (header.wav_format_tag) {
+      case 1:
+        if (sample_bytes == 1) {
+          drwav_u8_to_f32(out, p, num_samples);
+        } else if (sample_bytes == 2) {
+          std::vector<drwav_int16> samples(num_samples);
+          std::memcpy(samples.data(), p, num_samples * sample_bytes);
+          drwav_s16_to_f32(out, samples.data(), num_samples);
+        } else if (sample_bytes == 3) {
+          drwav_s24_to_f32(out, p, num_samples);
+        } else {
+          std::vector<drwav_int32> samples(num_samples);
+          std::memcpy(samples.data(), p, num_samples * sample_bytes);
+          drwav_s32_to_f32(out, samples.data(), num_samples);
+        }
+        break;
+      case 3:
+        if (sample_bytes == 4) {
+          std::memcpy(out, p, num_samples * sample_bytes);
+        } else {
+          std::vector<double> samples(num_samples);
+          std::memcpy(samples.data(), p, num_samples * sample_bytes);
+          drwav_f64_to_f32(out, samples.data(), num_samples);
+        }
+        break;
+      case 6:
+        drwav_alaw_to_f32(out, p, num_samples);
+        break;
+      default:
+        drwav_mulaw_to_f32(out, p, num_samples);
+        break;
+    }
+
+    const size_t consumed = num_samples * sample_bytes;
+    header.wav_data_left -= header.wav_data_left == UINT64_MAX ? 0 : consumed;
+    stream.bytes.erase(stream.bytes.begin(), stream.bytes.begin() + consumed);
+    if (header.wav_data_left == 0) {
+      // the chunks after the data are metadata.
+      stream.bytes.clear();
+    }
+  }
+
+  static OrtStatusPtr DecodeMp3(Stream& stream, bool eos, std::vector<float>& decoded) {
+    StreamState& header = stream.header;
+    if (header.mp3_skip_bytes > 0) {
+      const size_t skipped = static_cast<size_t>(std::min<uint64_t>(header.mp3_skip_bytes, stream.bytes.size()));
+      stream.bytes.erase(stream.bytes.begin(), stream.bytes.begin() + skipped);
+      header.mp3_skip_bytes -= skipped;
+    }
+
+    const auto replay = static_cast<size_t>(header.mp3_replay_bytes);
+    const size_t available = stream.bytes.size() - replay;
+    if (available == 0 || (!eos && available < kMp3Lookahead)) {
+      return nullptr;
+    }
+
+    // the start and the main data bytes of every frame decoded, the replayed ones first.
+    std::vector<std::pair<size_t, size_t>> frames;
+    drmp3dec mp3;
+    drmp3dec_init(&mp3);
+    std::vector<float> frame_pcm(DRMP3_MAX_SAMPLES_PER_FRAME);
+    size_t pos = 0;
+    for (;;) {
+      const size_t left = stream.bytes.size() - pos;
+      if (left == 0 || (!eos && pos >= replay && left < kMp3Lookahead)) {
+        break;
+      }
+
+      drmp3dec_frame_info info{};
+      const int samples = drmp3dec_decode_frame(&mp3, stream.bytes.data() + pos,
+                                                static_cast<int>(std::min<size_t>(left, INT_MAX)), frame_pcm.data(),
+                                                &info);
+      if (info.frame_bytes == 0) {
+        break;
+      }
+      const bool replayed = pos < replay;
+      const auto frame_bytes = static_cast<size_t>(info.frame_bytes);
+      // the bytes skipped without a frame have no rate.
+      frames.emplace_back(pos, info.hz == 0 ? 0 : frame_bytes - std::min(frame_bytes, kMp3FrameOverhead));
+      pos += frame_bytes;
+      if (samples == 0 || replayed) {
+        // skipped bytes before a frame, a frame without audio, or a frame decoded again for the decoder state.
+        continue;
+      }
+
+      if (header.sample_rate == 0) {
+        header.sample_rate = info.hz;
+        header.channels = info.channels;
+      } else if (header.sample_rate != info.hz || header.channels != info.channels) {
+        return OrtW::CreateStatus("[StreamingAudioDecoder]: the MP3 stream changes its format.",
+                                  ORT_INVALID_ARGUMENT);
+      }
+      decoded.insert(decoded.end(), frame_pcm.begin(), frame_pcm.begin() + samples * info.channels);
+    }
+
+    // keep the last frame, for the overlap of its transform, and the frames before it that fill the bit reservoir.
+    size_t keep_from = pos;
+    if (!frames.empty()) {
+      keep_from = frames.back().first;
+      size_t main_data = 0;
+      for (size_t i = frames.size() - 1; i > 0 && main_data < kMp3ReservoirBytes;) {
+        --i;
+        main_data += frames[i].second;
+        keep_from = frames[i].first;
+      }
+    }
+    stream.bytes.erase(stream.bytes.begin(), stream.bytes.begin() + keep_from);
+    header.mp3_replay_bytes = pos - keep_from;
+    return nullptr;
+  }
+
+  static OrtStatusPtr Decode(Stream& stream, bool eos, std::vector<float>& decoded) {
+    using AudioStreamType = AudioDecoder::AudioStreamType;
+    StreamState& header = stream.header;
+    const auto& bytes = stream.bytes;
+    if (header.format == static_cast<uint32_t>(AudioStreamType::kDefault)) {
+      if (bytes.size() < 4) {
+        return nullptr;
+      }
+
+      std::string_view marker(reinterpret_cast<const char*>(bytes.data()), 4);
+      if (marker == "RIFF") {
+        header.format = static_cast<uint32_t>(AudioStreamType::kWAV);
+      } else if (marker.substr(0, 3) == "ID3") {
+        // an ID3v2 tag: a 10 bytes header with the size of the tag as 4 bytes of 7 bits, then an optional footer.
+        if (bytes.size() < 10) {
+          return nullptr;
+        }
+        header.format = static_cast<uint32_t>(AudioStreamType::kMP3);
+        header.mp3_skip_bytes = 10 + ((bytes[6] & 0x7Fu) << 21 | (bytes[7] & 0x7Fu) << 14 |
+                                      (bytes[8] & 0x7Fu) << 7 | (bytes[9] & 0x7Fu)) +
+                                (bytes[5] & 0x10 ? 10 : 0);
+      } else if (marker[0] == char(0xFF) && (marker[1] | 0x1F) == char(0xFF)) {
+        header.format = static_cast<uint32_t>(AudioStreamType::kMP3);
+      } else if (marker == "fLaC") {
+        return OrtW::CreateStatus("[StreamingAudioDecoder]: FLAC streams cannot be decoded by chunks.",
+                                  ORT_INVALID_ARGUMENT);
+      } else {
+        return OrtW::CreateStatus("[StreamingAudioDecoder]: Cannot detect audio stream format",
+                                  ORT_INVALID_ARGUMENT);
+      }
+    }
+
+    if (stream.IsMP3()) {
+      return DecodeMp3(stream, eos, decoded);
+    }
+
+    if (header.wav_format_tag == 0) {
+      ORTX_RETURN_IF_ERROR(ReadWavHeader(stream));
+    }
+    if (header.wav_format_tag != 0) {
+      DecodeWav(stream, decoded);
+    }
+    return nullptr;
+  }
+
+  // Mixes, filters and resamples the decoded samples, and appends the samples ready to the pending ones.
+  OrtStatusPtr ProcessSamples(Stream& stream, bool eos, std::vector<float>& decoded) const {
+    StreamState& header = stream.header;
+    if (header.sample_rate == 0) {
+      return nullptr;
+    }
+
+    if (downsample_rate_ != 0 && header.sample_rate < downsample_rate_) {
+      return OrtW::CreateStatus("[StreamingAudioDecoder]: only down-sampling supported.", ORT_INVALID_ARGUMENT);
+    }
+    if (downsample_rate_ != 0 && header.sample_rate > PolyphaseResampler::kMaxDownRatio * downsample_rate_) {
+      return OrtW::CreateStatus(MakeString("[StreamingAudioDecoder]: cannot down-sample by more than ",
+                                           PolyphaseResampler::kMaxDownRatio, " times.")
+                                    .c_str(),
+                                ORT_INVALID_ARGUMENT);
+    }
+
+    std::optional<ChannelMixer> mixer;
+    ORTX_RETURN_IF_ERROR(
+        channel_mixing_.MakeMixer(static_cast<size_t>(header.channels), "[StreamingAudioDecoder]", mixer));
+    if (mixer) {
+      // each frame is read before its mono sample is written over the start of the buffer.
+      const size_t num_frames = decoded.size() / static_cast<size_t>(header.channels);
+      mixer->Process(decoded.data(), num_frames, decoded.data());
+      decoded.resize(num_frames);
+    }
+
+    if (downsample_rate_ == 0 || downsample_rate_ == header.sample_rate) {
+      stream.pending.insert(stream.pending.end(), decoded.begin(), decoded.end());
+      return nullptr;
+    }
+    if (header.channels > 1 && !mixer) {
+      return OrtW::CreateStatus(
+          "[StreamingAudioDecoder]: resampling needs the channels mixed, with stereo_to_mono, selected_channels or "
+          "channel_weights.",
+          ORT_INVALID_ARGUMENT);
+    }
+
+    ButterworthLowpass filter(0.5 * downsample_rate_, 1.0 * header.sample_rate);
+    filter.Process(decoded.data(), decoded.size(), header.filter_history);
+    auto& history = stream.history;
+    history.insert(history.end(), decoded.begin(), decoded.end());
+
+    PolyphaseResampler resampler(header.sample_rate, downsample_rate_);
+    // the history kept by the previous call starts at or before the first sample the next output depends on.
+    if (header.history_begin > std::max<int64_t>(0, resampler.FirstInput(header.next_output))) {
+      return OrtW::CreateStatus("[StreamingAudioDecoder]: invalid state.", ORT_INVALID_ARGUMENT);
+    }
+    const int64_t history_end = header.history_begin + static_cast<int64_t>(history.size());
+    const uint64_t ready = eos ? resampler.OutputLength(static_cast<size_t>(history_end))
+                               : resampler.ReadyOutputs(history_end);
+    if (ready > header.next_output) {
+      auto& pending = stream.pending;
+      const size_t offset = pending.size();
+      pending.resize(offset + static_cast<size_t>(ready - header.next_output));
+      resampler.Process(history.data(), header.history_begin, history.size(), header.next_output, ready,
+                        pending.data() + offset);
+      header.next_output = ready;
+    }
+
+    // keep the samples the next outputs depend on.
+    const int64_t keep_from = std::max(header.history_begin,
+                                       std::min(history_end, resampler.FirstInput(header.next_output)));
+    history.erase(history.begin(), history.begin() + (keep_from - header.history_begin));
+    header.history_begin = keep_from;
+    return nullptr;
+  }
+
+  int64_t downsample_rate_{};
+  ChannelMixing channel_mixing_;
+  int64_t window_length_{};
+};
@@ -0,0 +1,175 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "voice_activity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "thread_pool.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OCOS_VAD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCOS_VAD_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCOS_VAD_NEON
+#endif
+
+namespace {
+
+// frames whose features are computed by one task of the thread pool.
+constexpr size_t kFrameGrain = 256;
+
+// the mean square of a silent frame, -200 dB.
+constexpr float kMinMeanSquare = 1e-20f;
+
+}  // namespace
+
+void VoiceActivityDetector::FrameFeatures(const float* frame, size_t n, float& mean_square,
+                                          float& zero_crossing_rate) {
+  if (n == 0) {
+    mean_square = 0.0f;
+    zero_crossing_rate = 0.0f;
+    return;
+  }
+
+  // the sample i is squared, and compared with the sample i - 1 when i > 0.
+  float energy = frame[0] * frame[0];
+  uint32_t crossings = 0;
+  size_t i = 1;
+#if defined(OCOS_VAD_AVX2)
+  __m256 acc = _mm256_setzero_ps();
+  __m256i signs = _mm256_setzero_si256();
+  for (; i + 8 <= n; i += 8) {
+    const __m256 x = _mm256_loadu_ps(frame + i);
+    const __m256 changed = _mm256_xor_ps(x, _mm256_loadu_ps(frame + i - 1));
+    acc = _mm256_add_ps(acc, _mm256_mul_ps(x, x));
+    signs = _mm256_add_epi32(signs, _mm256_srli_epi32(_mm256_castps_si256(changed), 31));
+  }
+  alignas(32) float sums[8];
+  alignas(32) uint32_t counts[8];
+  _mm256_store_ps(sums, acc);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(counts), signs);
+  for (size_t k = 0; k < 8; ++k) {
+    energy += sums[k];
+    crossings += counts[k];
+  }
+#elif defined(OCOS_VAD_SSE2)
+  __m128 acc = _mm_setzero_ps();
+  __m128i signs = _mm_setzero_si128();
+  for (; i + 4 <= n; i += 4) {
+    const __m128 x = _mm_loadu_ps(frame + i);
+    const __m128 changed = _mm_xor_ps(x, _mm_loadu_ps(frame + i - 1));
+    acc = _mm_add_ps(acc, _mm_mul_ps(x, x));
+    signs = _mm_add_epi32(signs, _mm_srli_epi32(_mm_castps_si128(changed), 31));
+  }
+  alignas(16) float sums[4];
+  alignas(16) uint32_t counts[4];
+  _mm_store_ps(sums, acc);
+  _mm_store_si128(reinterpret_cast<__m128i*>(counts), signs);
+  for (size_t k = 0; k < 4; ++k) {
+    energy += sums[k];
+    crossings += counts[k];
+  }
+#elif defined(OCOS_VAD_NEON)
+  float32x4_t acc = vdupq_n_f32(0.0f);
+  uint32x4_t signs = vdupq_n_u32(0);
+  for (; i + 4 <= n; i += 4) {
+    const float32x4_t x = vld1q_f32(frame + i);
+    const uint32x4_t changed = veorq_u32(vreinterpretq_u32_f32(x), vreinterpretq_u32_f32(vld1q_f32(frame + i - 1)));
+    acc = vmlaq_f32(acc, x, x);
+    signs = vaddq_u32(signs, vshrq_n_u32(changed, 31));
+  }
+  energy += vaddvq_f32(acc);
+  crossings += vaddvq_u32(signs);
+#endif
+  for (; i < n; ++i) {
+    energy += frame[i] * frame[i];
+    crossings += std::signbit(frame[i]) != std::signbit(frame[i - 1]) ? 1 : 0;
+  }
+
+  mean_square = energy / static_cast<float>(n);
+  zero_crossing_rate = n > 1 ? static_cast<float>(crossings) / static_cast<float>(n - 1) : 0.0f;
+}
+
+std::vector<std::pair<int64_t, int64_t>> VoiceActivityDetector::Detect(const float* signal, size_t length) const {
+  const auto frame_length = static_cast<size_t>(options_.frame_length);
+  const size_t num_frames = (length + frame_length - 1) / frame_length;
+  std::vector<float> energies(num_frames);
+  std::vector<uint8_t> speech(num_frames);
+  ort_extensions::ParallelFor(num_frames, kFrameGrain, [&](size_t begin, size_t end) {
+    for (size_t f = begin; f < end; ++f) {
+      const size_t offset = f * frame_length;
+      float mean_square = 0.0f;
+      float zero_crossing_rate = 0.0f;
+      FrameFeatures(signal + offset, std::min(frame_length, length - offset), mean_square, zero_crossing_rate);
+      energies[f] = 10.0f * std::log10(std::max(mean_square, kMinMeanSquare));
+      speech[f] = energies[f] >= options_.energy_threshold && zero_crossing_rate <= options_.zero_crossing_threshold;
+    }
+  });
+
+  // the runs of speech frames, joined over the short pauses.
+  const auto total = static_cast<int64_t>(length);
+  std::vector<std::pair<int64_t, int64_t>> runs;
+  for (size_t f = 0; f < num_frames;) {
+    if (!speech[f]) {
+      ++f;
+      continue;
+    }
+    const size_t first = f;
+    while (f < num_frames && speech[f]) {
+      ++f;
+    }
+    const auto start = static_cast<int64_t>(first * frame_length);
+    const int64_t end = std::min(total, static_cast<int64_t>(f * frame_length));
+    if (!runs.empty() && start - runs.back().second < options_.min_silence_length) {
+      runs.back().second = end;
+    } else {
+      runs.emplace_back(start, end);
+    }
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> segments;
+  for (const auto& run : runs) {
+    if (run.second - run.first < options_.min_speech_length) {
+      continue;
+    }
+    const int64_t start = std::max<int64_t>(0, run.first - options_.padding);
+    const int64_t end = std::min(total, run.second + options_.padding);
+    if (!segments.empty() && start <= segments.back().second) {
+      segments.back().second = end;
+    } else {
+      segments.emplace_back(start, end);
+    }
+  }
+
+  const int64_t max_length = options_.max_segment_length;
+  if (max_length <= 0) {
+    return segments;
+  }
+
+  // the long segments are cut at the start of the quietest frame in (start + max_length / 2, start + max_length].
+  std::vector<std::pair<int64_t, int64_t>> chunks;
+  const auto frame = static_cast<int64_t>(frame_length);
+  for (auto [start, end] : segments) {
+    while (end - start > max_length) {
+      int64_t cut = start + max_length;
+      float quietest = std::numeric_limits<float>::infinity();
+      for (int64_t f = (start + max_length / 2) / frame + 1; f * frame <= start + max_length; ++f) {
+        if (energies[static_cast<size_t>(f)] < quietest) {
+          cut = f * frame;
+          quietest = energies[static_cast<size_t>(f)];
+        }
+      }
+      chunks.emplace_back(start, cut);
+      start = cut;
+    }
+    chunks.emplace_back(start, end);
+  }
+
+  return chunks;
+}
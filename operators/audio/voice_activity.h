@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Energy and zero-crossing voice activity detection, to cut a long recording into the speech segments worth running
+// a speech recognition model on. The signal is split into frames of frame_length samples; a frame is speech when its
+// energy is at least energy_threshold and its rate of zero crossings at most zero_crossing_threshold, which rejects
+// the broadband noise a loud fan or hiss makes. The runs of speech frames are then joined over the pauses shorter
+// than min_silence_length, the ones shorter than min_speech_length dropped, and the rest extended by padding on both
+// sides. The segments longer than max_segment_length are cut at the quietest frame of the second half of their
+// first max_segment_length samples, so that each one fits the input window of the model.
+class VoiceActivityDetector {
+ public:
+  // The lengths are in samples, the defaults for 16 kHz audio.
+  struct Options {
+    int64_t frame_length{480};
+    // dB of the mean square of a frame, relative to a full-scale constant signal.
+    float energy_threshold{-40.0f};
+    // sign changes per pair of consecutive samples.
+    float zero_crossing_threshold{0.4f};
+    int64_t min_speech_length{4000};
+    int64_t min_silence_length{8000};
+    int64_t padding{3200};
+    // 0 for no limit; 30 s, the window of Whisper, by default.
+    int64_t max_segment_length{480000};
+  };
+
+  // frame_length must be positive, and the other lengths not negative.
+  explicit VoiceActivityDetector(const Options& options) : options_(options) {}
+
+  // The mean square of frame[0, n) and the fraction of its n - 1 pairs of consecutive samples with different sign
+  // bits, computed in one pass on AVX2, SSE2 or NEON vectors.
+  static void FrameFeatures(const float* frame, size_t n, float& mean_square, float& zero_crossing_rate);
+
+  // The [start, end) sample positions of the speech segments of signal[0, length), in order and disjoint.
+  std::vector<std::pair<int64_t, int64_t>> Detect(const float* signal, size_t length) const;
+
+ private:
+  Options options_;
+};
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ocos.h"
+#include "fft.h"
+#include "thread_pool.h"
+
+// Squared magnitudes of the STFT of a batch of waveforms [B, T] as [B, bins, frames], matching
+// torch.stft(center=True, pad_mode="reflect").abs() ** 2: the waveform is reflected by n_fft / 2 samples at both
+// ends, and the frames of n_fft samples, 1 + (T + 2 * (n_fft / 2) - n_fft) / hop_length of them, are centered on every
+// hop_length-th sample. The window of frame_length <= n_fft samples is centered in the frame, and bins is
+// n_fft / 2 + 1 with the onesided attribute (the default) or n_fft without it.
+struct StftNormal {
+  StftNormal() = default;
+
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+    return OrtW::GetOpAttribute(info, "onesided", onesided_);
+  }
+
+  OrtStatusPtr Compute(const ortc::Tensor<float>& input0,
+                       int64_t n_fft,
+                       int64_t hop_length,
+                       const ortc::Span<float>& input3,
+                       int64_t frame_length,
+                       ortc::Tensor<float>& output0) const {
+    const std::vector<int64_t>& dimensions = input0.Shape();
+    if (dimensions.size() != 2) {
+      return OrtW::CreateStatus("[Stft] The input must be a [batch, samples] tensor.", ORT_INVALID_ARGUMENT);
+    }
+    if (n_fft <= 0 || hop_length <= 0) {
+      return OrtW::CreateStatus("[Stft] n_fft and hop_length must be positive.", ORT_INVALID_ARGUMENT);
+    }
+    if (frame_length <= 0 || frame_length > n_fft) {
+      return OrtW::CreateStatus("[Stft] The frame length must be in [1, n_fft].", ORT_INVALID_ARGUMENT);
+    }
+    if (static_cast<int64_t>(input3.size()) != frame_length) {
+      return OrtW::CreateStatus("[Stft] The window must have frame_length samples.", ORT_INVALID_ARGUMENT);
+    }
+
+    const auto batch = static_cast<size_t>(dimensions[0]);
+    const int64_t length = dimensions[1];
+    if (length <= n_fft / 2) {
+      return OrtW::CreateStatus("[Stft] The signal must be longer than n_fft / 2 samples.", ORT_INVALID_ARGUMENT);
+    }
+
+    // the window is padded with zeros on both sides to n_fft samples, like torch.stft does.
+    std::vector<float> window(static_cast<size_t>(n_fft), 0.0f);
+    std::copy(input3.data_, input3.data_ + frame_length, window.begin() + (n_fft - frame_length) / 2);
+    const ort_extensions::FramePowerSpectrum spectrum(std::move(window));
+
+    // an odd n_fft pads one sample less than a frame, and has no frame centered on the sample T.
+    const size_t frames = static_cast<size_t>((length + 2 * (n_fft / 2) - n_fft) / hop_length) + 1;
+    const size_t half_bins = spectrum.NumBins();
+    const size_t bins = onesided_ ? half_bins : static_cast<size_t>(n_fft);
+    float* out0 = output0.Allocate({dimensions[0], static_cast<int64_t>(bins), static_cast<int64_t>(frames)});
+    const float* X = input0.Data();
+
+    ort_extensions::ParallelFor(batch * frames, kFrameGrain, [&](size_t begin, size_t end) {
+      auto workspace = spectrum.MakeWorkspace();
+      std::vector<float> power(half_bins);
+      for (size_t i = begin; i < end; ++i) {
+        const size_t b = i / frames;
+        const size_t f = i % frames;
+        spectrum.Compute(X + b * static_cast<size_t>(length), length, static_cast<int64_t>(f) * hop_length,
+                         power.data(), workspace);
+
+        // the spectrum of a real signal is symmetric, |X[n - k]| = |X[k]|.
+        float* column = out0 + b * bins * frames + f;
+        for (size_t k = 0; k < bins; ++k) {
+          column[k * frames] = power[k < half_bins ? k : static_cast<size_t>(n_fft) - k];
+        }
+      }
+    });
+
+    return nullptr;
+  }
+
+ private:
+  // frames transformed by one task of the thread pool.
+  static constexpr size_t kFrameGrain = 16;
+
+  int64_t onesided_{1};
+};
@@ -0,0 +1,394 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "ecma_regex.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace ort_extensions {
+
+namespace {
+
+// the characters std::isspace accepts in the "C" locale; RE2's \s leaves out \v.
+constexpr const char* kSpaceChars = "\\t\\n\\v\\f\\r ";
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool IsAsciiAlnum(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// std::regex<char> compares bytes, so a code unit above 0xFF cannot match and non-ASCII bytes are folded by the
+// "C" locale only, which RE2 does not reproduce.
+bool AppendCodeUnit(unsigned value, bool icase, std::string& out) {
+  if (value > 0xFF || (icase && value >= 0x80)) {
+    return false;
+  }
+  char buf[8];
+  std::snprintf(buf, sizeof(buf), "\\x{%02x}", value);
+  out += buf;
+  return true;
+}
+
+bool ReadHex(std::string_view pattern, size_t pos, size_t digits, unsigned& value) {
+  if (pos + digits > pattern.size()) {
+    return false;
+  }
+  value = 0;
+  for (size_t i = 0; i < digits; ++i) {
+    int v = HexValue(pattern[pos + i]);
+    if (v < 0) {
+      return false;
+    }
+    value = value * 16 + static_cast<unsigned>(v);
+  }
+  return true;
+}
+
+// Translates the escape sequence starting at pattern[i] == '\\' and moves i past it.
+bool TranslateEscape(std::string_view pattern, size_t& i, bool in_class, bool icase, std::string& out) {
+  if (i + 1 >= pattern.size()) {
+    return false;
+  }
+  char c = pattern[i + 1];
+  i += 2;
+  unsigned value = 0;
+  switch (c) {
+    case 'd':
+    case 'D':
+    case 'w':
+    case 'W':
+    case 't':
+    case 'n':
+    case 'v':
+    case 'f':
+    case 'r':
+      out += '\\';
+      out += c;
+      return true;
+    case 'b':
+    case 'B':
+      if (in_class) {
+        // [\b] is a backspace, [\B] is an error.
+        return c == 'b' && AppendCodeUnit(0x08, icase, out);
+      }
+      out += '\\';
+      out += c;
+      return true;
+    case 's':
+      if (in_class) {
+        out += kSpaceChars;
+      } else {
+        out += '[';
+        out += kSpaceChars;
+        out += ']';
+      }
+      return true;
+    case 'S':
+      if (in_class) {
+        return false;
+      }
+      out += "[^";
+      out += kSpaceChars;
+      out += ']';
+      return true;
+    case '0':
+      // \0 followed by a digit is an octal escape in the legacy syntax.
+      if (i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9') {
+        return false;
+      }
+      return AppendCodeUnit(0, icase, out);
+    case 'x':
+      if (!ReadHex(pattern, i, 2, value)) {
+        return false;
+      }
+      i += 2;
+      return AppendCodeUnit(value, icase, out);
+    case 'u':
+      if (!ReadHex(pattern, i, 4, value)) {
+        return false;
+      }
+      i += 4;
+      return AppendCodeUnit(value, icase, out);
+    default:
+      // backreferences, \k<name>, \cX (which the standard libraries do not agree on) and the other letter escapes
+      // are left to std::regex.
+      if (IsAsciiAlnum(c)) {
+        return false;
+      }
+      if (static_cast<unsigned char>(c) >= 0x80) {
+        return AppendCodeUnit(static_cast<unsigned char>(c), icase, out);
+      }
+      // an escaped punctuation character is a literal in both syntaxes.
+      out += '\\';
+      out += c;
+      return true;
+  }
+}
+
+// Translates the character class starting at pattern[i] == '[' and moves i past it.
+bool TranslateClass(std::string_view pattern, size_t& i, bool icase, std::string& out) {
+  ++i;
+  bool negated = i < pattern.size() && pattern[i] == '^';
+  if (negated) {
+    ++i;
+  }
+  // ECMAScript closes a class on its first ']', RE2 would read it as a literal: [] never matches and [^] always does.
+  if (i < pattern.size() && pattern[i] == ']') {
+    ++i;
+    out += negated ? "[\\x{00}-\\x{ff}]" : "[^\\x{00}-\\x{ff}]";
+    return true;
+  }
+
+  out += negated ? "[^" : "[";
+  while (i < pattern.size()) {
+    char c = pattern[i];
+    if (c == ']') {
+      ++i;
+      out += ']';
+      return true;
+    }
+    if (c == '\\') {
+      if (!TranslateEscape(pattern, i, true, icase, out)) {
+        return false;
+      }
+      continue;
+    }
+    if (c == '[') {
+      // RE2 would take [: as the start of a POSIX class.
+      out += "\\[";
+    } else if (static_cast<unsigned char>(c) >= 0x80) {
+      if (!AppendCodeUnit(static_cast<unsigned char>(c), icase, out)) {
+        return false;
+      }
+    } else {
+      out += c;
+    }
+    ++i;
+  }
+  return false;
+}
+
+#ifdef ENABLE_RE2_REGEX
+void AppendFormat(std::string_view format, std::string_view text, size_t prefix_begin,
+                  const std::vector<re2::StringPiece>& groups, std::string& out) {
+  const auto& match = groups[0];
+  size_t match_begin = static_cast<size_t>(match.data() - text.data());
+  size_t match_end = match_begin + match.size();
+  for (size_t i = 0; i < format.size(); ++i) {
+    char c = format[i];
+    if (c != '$' || i + 1 == format.size()) {
+      out += c;
+      continue;
+    }
+    char next = format[i + 1];
+    if (next == '$') {
+      out += '$';
+      ++i;
+    } else if (next == '&') {
+      out.append(match.data(), match.size());
+      ++i;
+    } else if (next == '`') {
+      out.append(text.data() + prefix_begin, match_begin - prefix_begin);
+      ++i;
+    } else if (next == '\'') {
+      out.append(text.data() + match_end, text.size() - match_end);
+      ++i;
+    } else if (next >= '0' && next <= '9') {
+      size_t num = static_cast<size_t>(next - '0');
+      ++i;
+      if (i + 1 < format.size() && format[i + 1] >= '0' && format[i + 1] <= '9') {
+        num = num * 10 + static_cast<size_t>(format[++i] - '0');
+      }
+      if (num < groups.size() && groups[num].data() != nullptr) {
+        out.append(groups[num].data(), groups[num].size());
+      }
+    } else {
+      // not a format sequence, the next character is copied on its own.
+      out += '$';
+    }
+  }
+}
+#endif
+
+}  // namespace
+
+bool TranslateECMAScriptToRE2(std::string_view pattern, bool icase, std::string& translated) {
+  std::string& out = translated;
+  out.clear();
+  out.reserve(pattern.size() * 2);
+  size_t i = 0;
+  while (i < pattern.size()) {
+    char c = pattern[i];
+    switch (c) {
+      case '\\':
+        if (!TranslateEscape(pattern, i, false, icase, out)) {
+          return false;
+        }
+        break;
+      case '[':
+        if (!TranslateClass(pattern, i, icase, out)) {
+          return false;
+        }
+        break;
+      case '(':
+        if (pattern.compare(i, 3, "(?:") == 0) {
+          out += "(?:";
+          i += 3;
+        } else if (pattern.compare(i, 3, "(?<") == 0 && i + 3 < pattern.size() &&
+                   pattern[i + 3] != '=' && pattern[i + 3] != '!') {
+          out += "(?P<";
+          i += 3;
+        } else if (i + 1 < pattern.size() && pattern[i + 1] == '?') {
+          // lookahead and lookbehind
+          return false;
+        } else {
+          out += '(';
+          ++i;
+        }
+        break;
+      case '.':
+        // the ECMAScript dot stops at line terminators, RE2's only at \n.
+        out += "[^\\n\\r]";
+        ++i;
+        break;
+      default:
+        if (static_cast<unsigned char>(c) >= 0x80) {
+          if (!AppendCodeUnit(static_cast<unsigned char>(c), icase, out)) {
+            return false;
+          }
+        } else {
+          out += c;
+        }
+        ++i;
+        break;
+    }
+  }
+  return true;
+}
+
+ECMARegex::ECMARegex(std::string_view pattern, bool icase)
+    : pattern_(pattern), flags_(std::regex_constants::optimize | std::regex_constants::ECMAScript) {
+  if (icase) {
+    flags_ |= std::regex_constants::icase;
+  }
+
+#ifdef ENABLE_RE2_REGEX
+  std::string translated;
+  if (TranslateECMAScriptToRE2(pattern, icase, translated)) {
+    // Latin-1 makes RE2 match bytes, as std::regex does on a std::string.
+    re2::RE2::Options options;
+    options.set_encoding(re2::RE2::Options::EncodingLatin1);
+    options.set_case_sensitive(!icase);
+    options.set_log_errors(false);
+    auto compiled = std::make_unique<re2::RE2>(translated, options);
+    options.set_longest_match(true);
+    auto longest = std::make_unique<re2::RE2>(translated, options);
+    if (compiled->ok() && longest->ok()) {
+      re2_ = std::move(compiled);
+      re2_longest_ = std::move(longest);
+    }
+  }
+#endif
+
+  // the pattern errors are reported here when std::regex runs it.
+  if (!IsRE2()) {
+    StdRegex();
+  }
+}
+
+const std::regex& ECMARegex::StdRegex() const {
+  std::call_once(std_regex_once_, [this]() { std_regex_.assign(pattern_, flags_); });
+  return std_regex_;
+}
+
+#ifdef ENABLE_RE2_REGEX
+bool ECMARegex::HasNonEmptyMatchAt(const re2::StringPiece& input, size_t pos) const {
+  re2::StringPiece match;
+  return pos < input.size() && re2_longest_->Match(input, pos, input.size(), re2::RE2::ANCHOR_START, &match, 1) &&
+         !match.empty();
+}
+#endif
+
+bool ECMARegex::FullMatch(std::string_view text) const {
+#ifdef ENABLE_RE2_REGEX
+  if (re2_) {
+    return re2::RE2::FullMatch(re2::StringPiece(text.data(), text.size()), *re2_);
+  }
+#endif
+  return std::regex_match(text.data(), text.data() + text.size(), StdRegex());
+}
+
+void ECMARegex::ForEachMatch(std::string_view text, const std::function<void(size_t, size_t)>& fn) const {
+#ifdef ENABLE_RE2_REGEX
+  if (re2_) {
+    std::vector<std::pair<size_t, size_t>> matches;
+    re2::StringPiece input(text.data(), text.size());
+    re2::StringPiece match;
+    size_t pos = 0;
+    bool resolved = true;
+    while (pos <= text.size() && re2_->Match(input, pos, text.size(), re2::RE2::UNANCHORED, &match, 1)) {
+      size_t begin = static_cast<size_t>(match.data() - text.data());
+      if (match.empty() && HasNonEmptyMatchAt(input, begin)) {
+        resolved = false;
+        break;
+      }
+      matches.emplace_back(begin, match.size());
+      pos = begin + (match.empty() ? 1 : match.size());
+    }
+    if (resolved) {
+      for (auto& m : matches) {
+        fn(m.first, m.second);
+      }
+      return;
+    }
+  }
+#endif
+  const char* begin = text.data();
+  for (std::cregex_iterator it(begin, begin + text.size(), StdRegex()), end; it != end; ++it) {
+    fn(static_cast<size_t>(it->position()), static_cast<size_t>(it->length()));
+  }
+}
+
+void ECMARegex::Replace(std::string_view text, const std::string& format, bool global, std::string& result) const {
+  result.clear();
+#ifdef ENABLE_RE2_REGEX
+  if (re2_) {
+    std::vector<re2::StringPiece> groups(1 + static_cast<size_t>(re2_->NumberOfCapturingGroups()));
+    re2::StringPiece input(text.data(), text.size());
+    size_t last = 0;  // end of the previous match
+    size_t pos = 0;
+    bool resolved = true;
+    while (pos <= text.size() &&
+           re2_->Match(input, pos, text.size(), re2::RE2::UNANCHORED, groups.data(), static_cast<int>(groups.size()))) {
+      size_t begin = static_cast<size_t>(groups[0].data() - text.data());
+      if (global && groups[0].empty() && HasNonEmptyMatchAt(input, begin)) {
+        resolved = false;
+        break;
+      }
+      result.append(text.data() + last, begin - last);
+      AppendFormat(format, text, last, groups, result);
+      last = begin + groups[0].size();
+      if (!global) {
+        break;
+      }
+      pos = groups[0].empty() ? last + 1 : last;
+    }
+    if (resolved) {
+      result.append(text.data() + last, text.size() - last);
+      return;
+    }
+    result.clear();
+  }
+#endif
+  auto flags = global ? std::regex_constants::format_default : std::regex_constants::format_first_only;
+  std::regex_replace(std::back_inserter(result), text.begin(), text.end(), StdRegex(), format, flags);
+}
+
+}  // namespace ort_extensions
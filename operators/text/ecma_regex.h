@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <string_view>
+
+#ifdef ENABLE_RE2_REGEX
+#include "re2/re2.h"
+#endif
+
+namespace ort_extensions {
+
+// Rewrites an ECMAScript pattern into the RE2 syntax with the same meaning when it is matched byte by byte,
+// the way std::regex matches a std::string. Returns false if the pattern uses a construct RE2 cannot express,
+// such as backreferences and lookaround assertions.
+bool TranslateECMAScriptToRE2(std::string_view pattern, bool icase, std::string& translated);
+
+// A compiled ECMAScript regular expression for the ECMA regex kernels.
+// Patterns are run by RE2 whenever they can be translated, which keeps the matching time linear in the input;
+// the other ones fall back to std::regex. std::regex is only compiled when RE2 cannot run the pattern, or the first
+// time a row needs it, as it rejects some patterns RE2 accepts, such as named groups. Matching is const and safe to
+// share across threads.
+class ECMARegex {
+ public:
+  ECMARegex(std::string_view pattern, bool icase);
+
+  bool IsRE2() const {
+#ifdef ENABLE_RE2_REGEX
+    return re2_ != nullptr;
+#else
+    return false;
+#endif
+  }
+
+  // True if the whole text matches, as std::regex_match.
+  bool FullMatch(std::string_view text) const;
+
+  // Calls fn(begin, length) for each match in the order std::sregex_iterator visits them.
+  void ForEachMatch(std::string_view text, const std::function<void(size_t, size_t)>& fn) const;
+
+  // Same as std::regex_replace with the default format syntax ($&, $n, $nn, $`, $' and $$), replacing only the
+  // first match when global is false.
+  void Replace(std::string_view text, const std::string& format, bool global, std::string& result) const;
+
+ private:
+#ifdef ENABLE_RE2_REGEX
+  // After an empty match std::regex retries for a non-empty match at the same position, which RE2 cannot express;
+  // the rows where such a match exists are handed over to std::regex.
+  bool HasNonEmptyMatchAt(const re2::StringPiece& input, size_t pos) const;
+
+  std::unique_ptr<re2::RE2> re2_;
+  std::unique_ptr<re2::RE2> re2_longest_;  // same program with leftmost-longest semantics
+#endif
+  const std::regex& StdRegex() const;
+
+  std::string pattern_;
+  std::regex_constants::syntax_option_type flags_;
+  mutable std::once_flag std_regex_once_;
+  mutable std::regex std_regex_;
+};
+
+// Holds the last pattern compiled by a kernel instance; the patterns of these kernels are nearly always
+// constant initializers, so one entry avoids recompiling on every Compute.
+class ECMARegexCache {
+ public:
+  std::shared_ptr<const ECMARegex> Get(std::string_view pattern, bool icase) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!regex_ || icase_ != icase || pattern_ != pattern) {
+      regex_ = std::make_shared<const ECMARegex>(pattern, icase);
+      pattern_.assign(pattern.data(), pattern.size());
+      icase_ = icase;
+    }
+    return regex_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::string pattern_;
+  bool icase_{};
+  std::shared_ptr<const ECMARegex> regex_;
+};
+
+}  // namespace ort_extensions
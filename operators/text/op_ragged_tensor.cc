@@ -3,6 +3,9 @@
 #include "string_utils.h"
 #include "string_tensor.h"
 #include "op_ragged_tensor.hpp"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
 
 OrtStatusPtr RaggedTensorToSparse(const ortc::Tensor<int64_t>& n_element,
                                   ortc::Tensor<int64_t>& output_0,
@@ -41,13 +44,34 @@ OrtStatusPtr RaggedTensorToSparse(const ortc::Tensor<int64_t>& n_element,
   return nullptr;
 }
 
-static int64_t GetMaxRaggedTensorCol(int64_t n, const int64_t* p_indices) {
-  int64_t size = n;
-  int64_t max_col = 0;
-  for (int64_t i = 1; i < size; ++i) {
+// Checks that the row splits index the values in order and returns the length of the longest row.
+static OrtStatusPtr GetMaxRaggedTensorCol(int64_t n, const int64_t* p_indices, size_t n_values, int64_t& max_col) {
+  max_col = 0;
+  if (n > 0 && p_indices[0] < 0) {
+    return OrtW::CreateStatus(MakeString("Row splits must start at a non-negative index, not ", p_indices[0], "."),
+                              ORT_INVALID_ARGUMENT);
+  }
+  for (int64_t i = 1; i < n; ++i) {
+    if (p_indices[i] < p_indices[i - 1]) {
+      return OrtW::CreateStatus(MakeString("Row splits must not decrease, index ", i, " is ", p_indices[i],
+                                           " after ", p_indices[i - 1], "."),
+                                ORT_INVALID_ARGUMENT);
+    }
     max_col = std::max(max_col, p_indices[i] - p_indices[i - 1]);
   }
-  return max_col;
+  if (n > 0 && static_cast<uint64_t>(p_indices[n - 1]) > n_values) {
+    return OrtW::CreateStatus(MakeString("Row splits end at ", p_indices[n - 1], " beyond the ", n_values,
+                                         " values."),
+                              ORT_INVALID_ARGUMENT);
+  }
+  return nullptr;
+}
+
+// dense cells filled by one task of the thread pool.
+constexpr int64_t kDenseGrain = 16384;
+
+static size_t RowGrain(int64_t max_col) {
+  return static_cast<size_t>(max_col >= kDenseGrain ? 1 : kDenseGrain / (max_col + 1));
 }
 
 OrtStatusPtr KernelRaggedTensoroDense::Compute(const ortc::Tensor<int64_t>& input0,
@@ -60,61 +84,72 @@ OrtStatusPtr KernelRaggedTensoroDense::Compute(const ortc::Tensor<int64_t>& inpu
   const int64_t* p_indices = input3.Data();
 
   int64_t size = input3.NumberOfElement();
-  int64_t max_col = GetMaxRaggedTensorCol(size, p_indices);
+  int64_t max_col = 0;
+  ORTX_RETURN_IF_ERROR(
+      GetMaxRaggedTensorCol(size, p_indices, static_cast<size_t>(input1.NumberOfElement()), max_col));
 
-  std::vector<int64_t> shape_out{size - 1, max_col};
+  // row i of the output starts at i * max_col, so the rows are filled independently.
+  int64_t rows = size > 0 ? size - 1 : 0;
+  std::vector<int64_t> shape_out{rows, max_col};
   int64_t* dense = output.Allocate(shape_out);
-
-  int64_t pos = 0;
-  int64_t j, pos_end;
-  int64_t shape_out_size = shape_out[0] * shape_out[1];
-  for (int64_t i = 0; i < size - 1; ++i) {
-    pos_end = pos + max_col;
-    if (pos_end > shape_out_size)
-      return OrtW::CreateStatus(MakeString(
-                                    "Unexpected index ", pos_end, " greather than ", shape_out[0], "x", shape_out[1],
-                                    " - i=", i, " size=", size, ".")
-                                    .c_str(),
-                                ORT_INVALID_ARGUMENT);
-    for (j = p_indices[i]; j < p_indices[i + 1]; ++j, ++pos) {
-      dense[pos] = p_values[j];
-    }
-    for (; pos < pos_end; ++pos) {
-      dense[pos] = p_missing[0];
+  const int64_t missing = p_missing[0];
+  ort_extensions::ParallelFor(static_cast<size_t>(rows), RowGrain(max_col), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      int64_t* row = dense + i * max_col;
+      int64_t length = p_indices[i + 1] - p_indices[i];
+      if (length > 0) {
+        std::memcpy(row, p_values + p_indices[i], static_cast<size_t>(length) * sizeof(int64_t));
+      }
+      std::fill(row + length, row + max_col, missing);
     }
-  }
+  });
 
   return nullptr;
 }
 
 OrtStatusPtr StringRaggedTensorToDense(const ortc::Tensor<int64_t>& input0,
-                                       const ortc::Tensor<std::string>& input1,
+                                       const ortc::Tensor<std::string_view>& input1,
                                        const ortc::Tensor<int64_t>& input2,
-                                       const ortc::Tensor<std::string>& input3,
+                                       const ortc::Tensor<std::string_view>& input3,
                                        ortc::Tensor<std::string>& output) {
   auto& input = input1.Data();
   const int64_t* p_indices = input2.Data();
   int64_t size = input3.NumberOfElement();
-  int64_t max_col = GetMaxRaggedTensorCol(size, p_indices);
-  std::vector<int64_t> shape_out{size - 1, max_col};
-
-  int64_t shape_out_size = shape_out[0] * shape_out[1];
-  std::vector<std::string> dense(static_cast<size_t>(max_col * (size - 1)));
-  int64_t pos = 0;
-  int64_t j, pos_end;
-  for (int64_t i = 0; i < size - 1; ++i) {
-    pos_end = pos + max_col;
-    if (pos_end > shape_out_size)
-      return OrtW::CreateStatus(MakeString(
-                                    "Unexpected index ", pos_end, " greather than ", shape_out[0], "x", shape_out[1],
-                                    " - i=", i, " size=", size, ".")
-                                    .c_str(),
-                                ORT_INVALID_ARGUMENT);
-    for (j = p_indices[i]; j < p_indices[i + 1]; ++j, ++pos) {
-      dense[static_cast<size_t>(pos)] = input[static_cast<size_t>(j)];
+  int64_t max_col = 0;
+  ORTX_RETURN_IF_ERROR(GetMaxRaggedTensorCol(size, p_indices, input.size(), max_col));
+  int64_t rows = size > 0 ? size - 1 : 0;
+  std::vector<int64_t> shape_out{rows, max_col};
+
+  // the cells are laid out in the builder first, the values then copied into them row by row in parallel;
+  // the missing cells stay empty.
+  size_t num_bytes = 0;
+  if (rows > 0) {
+    for (int64_t j = p_indices[0]; j < p_indices[rows]; ++j) {
+      num_bytes += input[static_cast<size_t>(j)].size();
     }
-    pos = pos_end;
   }
+  ortc::StringTensorBuilder dense;
+  dense.Reserve(static_cast<size_t>(rows * max_col), num_bytes);
+  for (int64_t i = 0; i < rows; ++i) {
+    int64_t j = p_indices[i];
+    for (; j < p_indices[i + 1]; ++j) {
+      dense.AppendUninitialized(input[static_cast<size_t>(j)].size());
+    }
+    for (j -= p_indices[i]; j < max_col; ++j) {
+      dense.AppendUninitialized(0);
+    }
+  }
+
+  ort_extensions::ParallelFor(static_cast<size_t>(rows), RowGrain(max_col), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      size_t cell = i * static_cast<size_t>(max_col);
+      for (int64_t j = p_indices[i]; j < p_indices[i + 1]; ++j, ++cell) {
+        std::string_view value = input[static_cast<size_t>(j)];
+        std::memcpy(dense.MutableElement(cell), value.data(), value.size());
+      }
+    }
+  });
+
   output.SetStringOutput(dense, shape_out);
   return nullptr;
 }
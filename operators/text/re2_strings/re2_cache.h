@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "re2/re2.h"
+
+namespace ort_extensions {
+
+// A bounded LRU cache of compiled RE2 programs, keyed by pattern and options.
+// A compiled RE2 is immutable and safe to match from several threads, so the entries are shared with the callers;
+// an entry evicted while in use stays alive until the last caller releases it.
+class RE2Cache {
+ public:
+  static constexpr size_t kDefaultCapacity = 64;
+
+  explicit RE2Cache(size_t capacity = kDefaultCapacity) : capacity_(capacity == 0 ? 1 : capacity) {}
+  RE2Cache(const RE2Cache&) = delete;
+  RE2Cache& operator=(const RE2Cache&) = delete;
+
+  // Shared by all the kernels of the process.
+  static RE2Cache& ProcessWide() {
+    static RE2Cache cache;
+    return cache;
+  }
+
+  // Returns the compiled pattern; check ok() on the result, failed compilations are not cached.
+  std::shared_ptr<const re2::RE2> Get(std::string_view pattern, const re2::RE2::Options& options) {
+    std::string key = MakeKey(pattern, options);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        ++hits_;
+        return it->second->second;
+      }
+    }
+
+    // compile outside of the lock; two threads missing on the same key both compile, and the first one is kept.
+    ++misses_;
+    auto compiled = std::make_shared<const re2::RE2>(re2::StringPiece(pattern.data(), pattern.size()), options);
+    if (!compiled->ok()) {
+      return compiled;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+    }
+
+    entries_.emplace_front(key, compiled);
+    index_.emplace(std::move(key), entries_.begin());
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    return compiled;
+  }
+
+  std::shared_ptr<const re2::RE2> Get(std::string_view pattern) {
+    return Get(pattern, re2::RE2::DefaultOptions);
+  }
+
+  uint64_t Hits() const { return hits_.load(); }
+  uint64_t Misses() const { return misses_.load(); }
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+ private:
+  static std::string MakeKey(std::string_view pattern, const re2::RE2::Options& options) {
+    uint32_t flags = (options.encoding() == re2::RE2::Options::EncodingLatin1 ? 1u : 0u) |
+                     (options.posix_syntax() ? 1u << 1 : 0u) |
+                     (options.longest_match() ? 1u << 2 : 0u) |
+                     (options.literal() ? 1u << 3 : 0u) |
+                     (options.never_nl() ? 1u << 4 : 0u) |
+                     (options.dot_nl() ? 1u << 5 : 0u) |
+                     (options.never_capture() ? 1u << 6 : 0u) |
+                     (options.case_sensitive() ? 1u << 7 : 0u) |
+                     (options.perl_classes() ? 1u << 8 : 0u) |
+                     (options.word_boundary() ? 1u << 9 : 0u) |
+                     (options.one_line() ? 1u << 10 : 0u);
+    std::string key = std::to_string(flags) + ':' + std::to_string(options.max_mem()) + ':';
+    key.append(pattern.data(), pattern.size());
+    return key;
+  }
+
+  using Entry = std::pair<std::string, std::shared_ptr<const re2::RE2>>;
+
+  const size_t capacity_;
+  mutable std::mutex mutex_;
+  std::list<Entry> entries_;  // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  std::atomic<uint64_t> hits_{};
+  std::atomic<uint64_t> misses_{};
+};
+
+}  // namespace ort_extensions
@@ -5,6 +5,7 @@
 
 #include "ocos.h"
 #include "string_utils.h"
+#include "re2_cache.h"
 
 // See https://github.com/tensorflow/text/blob/master/docs/api_docs/python/text/regex_split_with_offsets.md.
 OrtStatusPtr KernelStringRegexSplitWithOffsets(const ortc::Tensor<std::string>& input,
@@ -13,18 +14,23 @@ OrtStatusPtr KernelStringRegexSplitWithOffsets(const ortc::Tensor<std::string>&
                                                ortc::Tensor<std::string>& output_text,
                                                ortc::Tensor<int64_t>& output_begin,
                                                ortc::Tensor<int64_t>& output_end,
-                                               ortc::Tensor<int64_t>& output_offset);
+                                               ortc::Tensor<int64_t>& output_offset,
+                                               ortc::ComputeArena& arena);
 
 struct KernelStringRegexReplace {
   OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
     return OrtW::GetOpAttribute(info, "global_replace", global_replace_);
   }
 
-  OrtStatusPtr Compute(const ortc::Tensor<std::string>& input,
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
                        std::string_view str_pattern,
                        std::string_view str_rewrite,
                        ortc::Tensor<std::string>& output) const;
 
+  const ort_extensions::RE2Cache& RegexCache() const { return regex_cache_; }
+
  protected:
   int64_t global_replace_{1};
+  // the pattern is usually a constant initializer, so it is compiled once per kernel.
+  mutable ort_extensions::RE2Cache regex_cache_;
 };
@@ -8,7 +8,7 @@
 #include "string_tensor.h"
 #include "string_regex.h"
 
-OrtStatusPtr KernelStringRegexReplace::Compute(const ortc::Tensor<std::string>& input,
+OrtStatusPtr KernelStringRegexReplace::Compute(const ortc::Tensor<std::string_view>& input,
                                                std::string_view str_pattern,
                                                std::string_view str_rewrite,
                                                ortc::Tensor<std::string>& output) const {
@@ -16,22 +16,26 @@ OrtStatusPtr KernelStringRegexReplace::Compute(const ortc::Tensor<std::string>&
     return OrtW::CreateStatus("pattern (second input) cannot be empty.", ORT_INVALID_ARGUMENT);
 
   // Setup output
-  std::vector<std::string> str_input{input.Data()};
+  const auto& str_input = input.Data();
   auto dim = input.Shape();
   size_t size = input.NumberOfElement();
 
-  re2::StringPiece piece(str_rewrite.data());
-  re2::RE2 reg(str_pattern.data());
+  re2::StringPiece piece(str_rewrite.data(), str_rewrite.size());
+  auto compiled = regex_cache_.Get(str_pattern);
+  const re2::RE2& reg = *compiled;
 
-  if (global_replace_) {
-    for (size_t i = 0; i < size; i++) {
-      re2::RE2::GlobalReplace(&(str_input[i]), reg, piece);
-    }
-  } else {
-    for (size_t i = 0; i < size; i++) {
-      re2::RE2::Replace(&(str_input[i]), reg, piece);
+  // RE2 rewrites in place, so each element goes through one reusable scratch string.
+  std::string scratch;
+  ortc::StringTensorBuilder str_output;
+  for (size_t i = 0; i < size; i++) {
+    scratch.assign(str_input[i]);
+    if (global_replace_) {
+      re2::RE2::GlobalReplace(&scratch, reg, piece);
+    } else {
+      re2::RE2::Replace(&scratch, reg, piece);
     }
+    str_output.Append(scratch);
   }
-  output.SetStringOutput(str_input, dim);
+  output.SetStringOutput(str_output, dim);
   return nullptr;
 }
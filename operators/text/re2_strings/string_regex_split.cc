@@ -13,7 +13,8 @@ OrtStatusPtr KernelStringRegexSplitWithOffsets(const ortc::Tensor<std::string>&
                                                ortc::Tensor<std::string>& output_text,
                                                ortc::Tensor<int64_t>& output_begin,
                                                ortc::Tensor<int64_t>& output_end,
-                                               ortc::Tensor<int64_t>& output_offset) {
+                                               ortc::Tensor<int64_t>& output_offset,
+                                               ortc::ComputeArena& arena) {
   // Setup inputs
   std::vector<std::string> str_input(input.Data());
 
@@ -29,22 +30,32 @@ OrtStatusPtr KernelStringRegexSplitWithOffsets(const ortc::Tensor<std::string>&
   auto dimensions = input.Shape();
   bool include_delimiter = (str_keep_pattern.Data().size() == 1) && (!str_keep_pattern.Data()[0].empty());
 
-  re2::RE2 reg(str_pattern.data());
-  re2::RE2 keep_reg(include_delimiter ? str_keep_pattern.Data()[0].data() : "");
+  // a function kernel has no state of its own, so the compiled patterns live in the process-wide cache.
+  auto& regex_cache = ort_extensions::RE2Cache::ProcessWide();
+  auto compiled = regex_cache.Get(str_pattern);
+  auto compiled_keep = regex_cache.Get(include_delimiter ? std::string_view(str_keep_pattern.Data()[0]) : "");
+  const re2::RE2& reg = *compiled;
+  const re2::RE2& keep_reg = *compiled_keep;
 
-  std::vector<std::string> all_tokens;
-  std::vector<int64_t> all_begin_offsets, all_end_offsets;
-  std::vector<int64_t> row_offsets;
+  ortc::StringTensorBuilder all_tokens;
+  ortc::ArenaAllocator<int64_t> offset_allocator(arena);
+  ortc::ArenaVector<int64_t> all_begin_offsets(offset_allocator), all_end_offsets(offset_allocator);
+  ortc::ArenaVector<int64_t> row_offsets(offset_allocator);
 
+  ortc::ArenaVector<std::string_view> tokens(offset_allocator);
+  ortc::ArenaVector<int64_t> begin_offsets(offset_allocator);
+  ortc::ArenaVector<int64_t> end_offsets(offset_allocator);
   for (int64_t i = 0; i < dimensions[0]; i++) {
     row_offsets.push_back(all_begin_offsets.size());
-    std::vector<std::string_view> tokens;
-    std::vector<int64_t> begin_offsets;
-    std::vector<int64_t> end_offsets;
+    tokens.clear();
+    begin_offsets.clear();
+    end_offsets.clear();
     RegexSplitImpl(str_input[static_cast<size_t>(i)], reg,
                    include_delimiter, keep_reg,
                    tokens, begin_offsets, end_offsets);
-    all_tokens.insert(all_tokens.end(), tokens.begin(), tokens.end());
+    for (auto token : tokens) {
+      all_tokens.Append(token);
+    }
     for (size_t j = 0; j < begin_offsets.size(); ++j) {
       all_begin_offsets.push_back(begin_offsets[j]);
       all_end_offsets.push_back(end_offsets[j]);
@@ -3,15 +3,17 @@
 
 #pragma once
 #include <string>
+#include <string_view>
+#include <vector>
 #include <algorithm>
 #include "re2/re2.h"
 
-template <typename T>
+template <typename T, typename TokenAllocator, typename OffsetAllocator>
 void RegexSplitImpl(const std::string& input, const RE2& pattern,
                     bool include_delimiter, const RE2& include_delim_regex,
-                    std::vector<std::string_view>& tokens,
-                    std::vector<T>& begin_offsets,
-                    std::vector<T>& end_offsets) {
+                    std::vector<std::string_view, TokenAllocator>& tokens,
+                    std::vector<T, OffsetAllocator>& begin_offsets,
+                    std::vector<T, OffsetAllocator>& end_offsets) {
   re2::StringPiece leftover(input.data());
   re2::StringPiece last_end = leftover;
   re2::StringPiece extracted_delim_token;
@@ -4,8 +4,8 @@
 #include "string_ecmaregex_replace.hpp"
 #include <vector>
 #include <algorithm>
-#include <regex>
 #include "string_tensor.h"
+#include "thread_pool.h"
 
 OrtStatusPtr KernelStringECMARegexReplace::OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
   auto status = OrtW::GetOpAttribute(info, "global_replace", global_replace_);
@@ -15,36 +15,29 @@ OrtStatusPtr KernelStringECMARegexReplace::OnModelAttach(const OrtApi& api, cons
   return status;
 }
 
-OrtStatusPtr KernelStringECMARegexReplace::Compute(const ortc::Tensor<std::string>& input,
+OrtStatusPtr KernelStringECMARegexReplace::Compute(const ortc::Tensor<std::string_view>& input,
                                            std::string_view pattern,
                                            std::string_view rewrite,
                                            ortc::Tensor<std::string>& output) const {
-  // make a copy as input is constant;
-  std::vector<std::string> str_input = input.Data();
   if (pattern.empty()) {
     return OrtW::CreateStatus("pattern (second input) cannot be empty.", ORT_INVALID_GRAPH);
   }
-  size_t size = input.NumberOfElement();
+  auto& str_input = input.Data();
+  size_t size = str_input.size();
 
-  auto regex_flag = std::regex_constants::optimize | std::regex_constants::ECMAScript;
-  if (ignore_case_) {
-    regex_flag |= std::regex_constants::icase;
-  }
-
-  std::regex reg(pattern.data(), regex_flag);
+  auto reg = regex_cache_.Get(pattern, ignore_case_ != 0);
+  std::string format(rewrite);
+  bool global = global_replace_ != 0;
 
-  if (global_replace_) {
-    for (size_t i = 0; i < size; i++) {
-      str_input[i] = std::regex_replace(str_input[i], reg, rewrite.data());
+  std::vector<std::string> str_output(size);
+  ort_extensions::ParallelFor(size, 4, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      reg->Replace(str_input[i], format, global, str_output[i]);
     }
-  } else {
-    for (size_t i = 0; i < size; i++) {
-      str_input[i] = std::regex_replace(str_input[i], reg, rewrite.data(), std::regex_constants::format_first_only);
-    }
-  }
+  });
 
   auto& dimensions = input.Shape();
-  output.SetStringOutput(str_input, dimensions);
+  output.SetStringOutput(str_output, dimensions);
 
   return nullptr;
 }
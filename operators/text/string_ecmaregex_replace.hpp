@@ -5,10 +5,11 @@
 
 #include "ocos.h"
 #include "string_utils.h"
+#include "ecma_regex.h"
 
 struct KernelStringECMARegexReplace {
   OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info);
-  OrtStatusPtr Compute(const ortc::Tensor<std::string>& input,
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
                std::string_view pattern,
                std::string_view rewrite,
                ortc::Tensor<std::string>& output) const;
@@ -16,4 +17,5 @@ struct KernelStringECMARegexReplace {
  protected:
   int64_t global_replace_{1};
   int64_t ignore_case_{0};
+  mutable ort_extensions::ECMARegexCache regex_cache_;
 };
@@ -3,54 +3,71 @@
 
 #include <string>
 #include <algorithm>
-#include <regex>
 #include <vector>
 #include <cmath>
 #include "string_ecmaregex_split.hpp"
 #include "string_tensor.h"
+#include "thread_pool.h"
+
+void ECMARegexSplit(std::string_view text, const ort_extensions::ECMARegex& pattern,
+                    const ort_extensions::ECMARegex* keep_pattern, std::vector<std::pair<int64_t, int64_t>>& spans) {
+  size_t prev_pos = 0;
+  pattern.ForEachMatch(text, [&](size_t cur_pos, size_t matched_length) {
+    if (prev_pos != cur_pos) {
+      spans.emplace_back(prev_pos, cur_pos);
+      prev_pos = cur_pos;
+    }
+    if (keep_pattern && keep_pattern->FullMatch(text.substr(cur_pos, matched_length))) {
+      spans.emplace_back(prev_pos, prev_pos + matched_length);
+    }
+    // the delimiter is skipped whether it is kept or not
+    prev_pos += matched_length;
+  });
+  if (prev_pos != text.size()) {
+    spans.emplace_back(prev_pos, text.size());
+  }
+}
 
 OrtStatusPtr KernelStringECMARegexSplitWithOffsets::OnModelAttach(const OrtApi& api,
                                                                   const OrtKernelInfo& info) {
   return OrtW::GetOpAttribute(info, "ignore_case", ignore_case_);
 }
 
-OrtStatusPtr KernelStringECMARegexSplitWithOffsets::Compute(const ortc::Tensor<std::string>& input,
+OrtStatusPtr KernelStringECMARegexSplitWithOffsets::Compute(const ortc::Tensor<std::string_view>& input,
                                                             std::string_view pattern,
                                                             std::string_view keep_pattern,
                                                             ortc::Tensor<std::string>& output_text,
                                                             ortc::Tensor<int64_t>& output1,
                                                             ortc::Tensor<int64_t>& output2,
-                                                            ortc::Tensor<int64_t>& output3) const {
+                                                            ortc::Tensor<int64_t>& output3,
+                                                            ortc::ComputeArena& arena) const {
   // Setup inputs
   auto& str_input = input.Data();
-
-  auto& dimensions = input.Shape();
+  size_t num_rows = str_input.size();
   bool include_delimiter = !keep_pattern.empty();
 
-  auto regex_flag = std::regex_constants::ECMAScript;
-  if (ignore_case_) {
-    regex_flag |= std::regex_constants::icase;
-  }
-
-  std::regex reg(pattern.data(), regex_flag);
-  std::regex keep_reg(include_delimiter ? keep_pattern.data() : "", regex_flag);
+  auto reg = regex_cache_.Get(pattern, ignore_case_ != 0);
+  auto keep_reg = include_delimiter ? keep_regex_cache_.Get(keep_pattern, ignore_case_ != 0) : nullptr;
 
-  std::vector<std::string> all_tokens;
-  std::vector<int64_t> all_begin_offsets, all_end_offsets;
-  std::vector<int64_t> row_offsets;
+  // the rows are split in parallel, each one into its own list of token spans.
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> row_spans(num_rows);
+  ort_extensions::ParallelFor(num_rows, 4, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      ECMARegexSplit(str_input[i], *reg, keep_reg.get(), row_spans[i]);
+    }
+  });
 
-  for (int64_t i = 0; i < dimensions[0]; i++) {
+  ortc::StringTensorBuilder all_tokens;
+  ortc::ArenaAllocator<int64_t> offset_allocator(arena);
+  ortc::ArenaVector<int64_t> all_begin_offsets(offset_allocator), all_end_offsets(offset_allocator);
+  ortc::ArenaVector<int64_t> row_offsets(offset_allocator);
+  row_offsets.reserve(num_rows + 1);
+  for (size_t i = 0; i < num_rows; i++) {
     row_offsets.push_back(all_begin_offsets.size());
-    std::vector<std::string_view> tokens;
-    std::vector<int64_t> begin_offsets;
-    std::vector<int64_t> end_offsets;
-    ECMARegexSplitImpl(str_input[static_cast<size_t>(i)], reg,
-                       include_delimiter, keep_reg,
-                       tokens, begin_offsets, end_offsets);
-    all_tokens.insert(all_tokens.end(), tokens.begin(), tokens.end());
-    for (size_t j = 0; j < begin_offsets.size(); ++j) {
-      all_begin_offsets.push_back(begin_offsets[j]);
-      all_end_offsets.push_back(end_offsets[j]);
+    for (auto& span : row_spans[i]) {
+      all_tokens.Append(str_input[i].substr(span.first, span.second - span.first));
+      all_begin_offsets.push_back(span.first);
+      all_end_offsets.push_back(span.second);
     }
   }
   row_offsets.push_back(all_begin_offsets.size());
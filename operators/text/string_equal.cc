@@ -1,158 +1,150 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstring>
 #include "string_functions.h"
 #include "string_tensor.h"
+#include "thread_pool.h"
 
-template <typename T1, typename T2, typename T3>
-class BroadcastIteratorRight {
- public:
-  BroadcastIteratorRight() = default;
-  OrtStatusPtr Init(const std::vector<int64_t>& shape1,
-                    const std::vector<int64_t>& shape2,
-                    const T1* p1, const T2* p2, T3* p3) {
-    shape1_ = shape1;
-    p1_ = p1;
-    p2_ = p2;
-    p3_ = p3;
-    if (shape2.size() > shape1.size()) {
-      return OrtW::CreateStatus("shape2 must have less dimensions than shape1", ORT_INVALID_ARGUMENT);
+namespace {
+
+// elements compared by one task of the thread pool.
+constexpr int64_t kCompareGrain = 4096;
+
+// The first 8 bytes of a string, zero padded. Two strings of the same length with the same prefix word only
+// differ after their 8th byte.
+inline uint64_t PrefixWord(std::string_view str) {
+  uint64_t word = 0;
+  std::memcpy(&word, str.data(), str.size() < sizeof(word) ? str.size() : sizeof(word));
+  return word;
+}
+
+// The lengths and prefix words of the smaller input, computed once and reused for every element it is broadcast to.
+struct Prefilter {
+  explicit Prefilter(const ortc::StringViews& strs) : lengths(strs.size()), prefixes(strs.size()) {
+    for (size_t i = 0; i < strs.size(); ++i) {
+      lengths[i] = strs[i].size();
+      prefixes[i] = PrefixWord(strs[i]);
     }
-    shape2_.resize(shape1_.size());
-    cum_shape2_.resize(shape1_.size());
-    total_ = 1;
-    for (size_t i = 0; i < shape1_.size(); ++i) {
-      total_ *= shape1[i];
-      if (i >= shape2.size()) {
-        shape2_[i] = 1;
-        continue;
-      } else {
-        shape2_[i] = shape2[i];
-      }
-      if (shape2[i] != 1 && shape1[i] != shape2[i]) {
-        return OrtW::CreateStatus(MakeString(
-                                      "Cannot broadcast dimension ", i, " left:", shape1[i], " right:", shape2[i])
-                                      .c_str(),
-                                  ORT_INVALID_ARGUMENT);
-      }
+  }
+
+  std::vector<size_t> lengths;
+  std::vector<uint64_t> prefixes;
+};
+
+// Compares x[0, n) with y[0, n), or with y[0] broadcast when kBroadcast. The lengths are compared first in a loop
+// without branches, then only the strings of equal length have their prefix words and remaining bytes compared.
+template <bool kBroadcast>
+void CompareRun(const ortc::StringViews& x, size_t x_offset, const ortc::StringViews& y, const Prefilter& filter,
+                size_t y_offset, size_t n, bool* out) {
+  const size_t* y_lengths = filter.lengths.data() + y_offset;
+  for (size_t j = 0; j < n; ++j) {
+    out[j] = x[x_offset + j].size() == y_lengths[kBroadcast ? 0 : j];
+  }
+
+  for (size_t j = 0; j < n; ++j) {
+    if (!out[j]) {
+      continue;
     }
-    cum_shape2_[shape2_.size() - 1] = 1;
-    for (size_t i = 1; i < shape1_.size(); ++i) {
-      cum_shape2_[shape1_.size() - i - 1] = cum_shape2_[shape1_.size() - i] * shape2_[shape1_.size() - i];
+    const size_t k = y_offset + (kBroadcast ? 0 : j);
+    std::string_view s1 = x[x_offset + j];
+    out[j] = PrefixWord(s1) == filter.prefixes[k] &&
+             (s1.size() <= sizeof(uint64_t) ||
+              std::memcmp(s1.data() + sizeof(uint64_t), y[k].data() + sizeof(uint64_t),
+                          s1.size() - sizeof(uint64_t)) == 0);
+  }
+}
+
+// Compares every element of x with the element of y at the same index, y being broadcast along the dimensions
+// where its shape is 1. The shape of y is padded with 1 on the right when it has fewer dimensions.
+OrtStatusPtr BroadcastEqual(const std::vector<int64_t>& shape1,
+                            const std::vector<int64_t>& shape2,
+                            const ortc::StringViews& x,
+                            const ortc::StringViews& y,
+                            bool* out) {
+  const size_t rank = shape1.size();
+  if (shape2.size() > rank) {
+    return OrtW::CreateStatus("shape2 must have less dimensions than shape1", ORT_INVALID_ARGUMENT);
+  }
+
+  // strides of y along the dimensions of x, 0 where y is broadcast.
+  std::vector<int64_t> stride2(rank);
+  int64_t stride = 1;
+  for (size_t i = rank; i-- > 0;) {
+    int64_t dim2 = i < shape2.size() ? shape2[i] : 1;
+    if (dim2 != 1 && dim2 != shape1[i]) {
+      return OrtW::CreateStatus(
+          MakeString("Cannot broadcast dimension ", i, " left:", shape1[i], " right:", shape2[i]).c_str(),
+          ORT_INVALID_ARGUMENT);
     }
+    stride2[i] = dim2 == 1 ? 0 : stride;
+    stride *= dim2;
+  }
 
+  if (x.empty()) {
     return nullptr;
   }
 
-  struct BroadcastIteratorRightState {
-    const BroadcastIteratorRight<T1, T2, T3>* parent = nullptr;
-    std::vector<int64_t> index1;
-    const T1* p1 = nullptr;
-    const T1* end_ = nullptr;
-    const T2* p2 = nullptr;
-    T3* p3 = nullptr;
-    size_t last = 0;
-    int dim = -1;
-
-    void init(const BroadcastIteratorRight<T1, T2, T3>& p) {
-      parent = &p;
-      p1 = p.p1_;
-      p2 = p.p2_;
-      p3 = p.p3_;
-      end_ = p.p1_ + p.total_;
-      index1.resize(p.shape1_.size(), 0);
-      last = index1.size() - 1;
+  // the trailing dimensions along which y is either contiguous or constant form one flat inner run.
+  const bool broadcast = rank > 0 && stride2[rank - 1] == 0;
+  int64_t inner = 1;
+  size_t outer_rank = rank;
+  for (; outer_rank > 0; --outer_rank) {
+    const size_t i = outer_rank - 1;
+    if (shape1[i] != 1 && stride2[i] != (broadcast ? 0 : inner)) {
+      break;
     }
+    inner *= shape1[i];
+  }
 
-    bool end() {
-      return p1 == end_;
+  const Prefilter filter(y);
+  const int64_t outer = static_cast<int64_t>(x.size()) / inner;
+  const int64_t grain = inner >= kCompareGrain ? 1 : kCompareGrain / inner;
+  ort_extensions::ParallelFor(static_cast<size_t>(outer), static_cast<size_t>(grain), [&](size_t begin, size_t end) {
+    // the index of the first run over the outer dimensions, then advanced run by run.
+    std::vector<int64_t> index(outer_rank);
+    int64_t y_offset = 0;
+    for (size_t i = outer_rank, rest = begin; i-- > 0;) {
+      index[i] = static_cast<int64_t>(rest % static_cast<size_t>(shape1[i]));
+      rest /= static_cast<size_t>(shape1[i]);
+      y_offset += index[i] * stride2[i];
     }
 
-    void next() {
-      ++index1[last];
-      ++p1;
-      ++p3;
-      if (parent->shape2_[last] != 1) {
-        ++p2;
-      }
-      dim = static_cast<int>(last);
-      while (dim > 0 && index1[dim] >= parent->shape1_[dim]) {
-        index1[dim] = 0;
-        if (parent->shape2_[dim] != 1) {
-          p2 -= parent->cum_shape2_[dim] * parent->shape2_[dim];
-        }
-        --dim;
-        ++index1[dim];
-        if (parent->shape2_[dim] != 1) {
-          p2 += parent->cum_shape2_[dim];
-        }
+    for (size_t run = begin; run < end; ++run) {
+      const size_t x_offset = run * static_cast<size_t>(inner);
+      if (broadcast) {
+        CompareRun<true>(x, x_offset, y, filter, static_cast<size_t>(y_offset), static_cast<size_t>(inner),
+                         out + x_offset);
+      } else {
+        CompareRun<false>(x, x_offset, y, filter, static_cast<size_t>(y_offset), static_cast<size_t>(inner),
+                          out + x_offset);
       }
-    }
 
-    template <typename TCMP>
-    OrtStatusPtr loop(TCMP& cmp, BroadcastIteratorRightState& /*it*/, int64_t pos = 0) {
-      if (pos != 0)
-        return OrtW::CreateStatus("Not implemented yet.", ORT_NOT_IMPLEMENTED);
-      while (!end()) {
-        *p3 = cmp(*p1, *p2);
-        next();
+      for (size_t i = outer_rank; i-- > 0;) {
+        y_offset += stride2[i];
+        if (++index[i] < shape1[i]) {
+          break;
+        }
+        y_offset -= index[i] * stride2[i];
+        index[i] = 0;
       }
-      return nullptr;
     }
-  };
-
- protected:
-  OrtStatusPtr status_{};
-  std::vector<int64_t> shape1_;
-  std::vector<int64_t> shape2_;
-  std::vector<int64_t> cum_shape2_;
-  int64_t total_{};
-  const T1* p1_{};
-  const T2* p2_{};
-  T3* p3_{};
-};
-
-template <typename T>
-class Compare {
- public:
-  inline bool operator()(const T& s1, const T& s2) const;
-};
+  });
 
-template <>
-inline bool Compare<std::string>::operator()(const std::string& s1, const std::string& s2) const {
-  return s1.compare(s2) == 0;
+  return nullptr;
 }
 
-OrtStatusPtr string_equal(const ortc::Tensor<std::string>& input_1,
-                          const ortc::Tensor<std::string>& input_2,
-                          ortc::Tensor<bool>& output) {
-  // Setup inputs
-  std::vector<std::string> X = input_1.Data();
-  std::vector<std::string> Y = input_2.Data();
+}  // namespace
 
-  OrtStatusPtr status = nullptr;
-  Compare<std::string> cmp;
-  typename BroadcastIteratorRight<std::string, std::string, bool>::BroadcastIteratorRightState state;
+OrtStatusPtr string_equal(const ortc::Tensor<std::string_view>& input_1,
+                          const ortc::Tensor<std::string_view>& input_2,
+                          ortc::Tensor<bool>& output) {
   if (input_1.NumberOfElement() >= input_2.NumberOfElement()) {
     bool* out = output.Allocate(input_1.Shape());
-    BroadcastIteratorRight<std::string, std::string, bool> iter;
-    status = iter.Init(
-        input_1.Shape(), input_2.Shape(), X.data(), Y.data(), out);
-    if (!status) {
-      state.init(iter);
-      status = state.loop(cmp, state);
-    }
-  } else {
-    // Operator Equal is commutative.
-    bool* out = output.Allocate(input_2.Shape());
-    BroadcastIteratorRight<std::string, std::string, bool> iter;
-    status = iter.Init(
-        input_2.Shape(), input_1.Shape(), Y.data(), X.data(), out);
-    if (!status) {
-      state.init(iter);
-      status = state.loop(cmp, state);
-    }
+    return BroadcastEqual(input_1.Shape(), input_2.Shape(), input_1.Data(), input_2.Data(), out);
   }
 
-  return status;
+  // Operator Equal is commutative.
+  bool* out = output.Allocate(input_2.Shape());
+  return BroadcastEqual(input_2.Shape(), input_1.Shape(), input_2.Data(), input_1.Data(), out);
 }
@@ -16,34 +16,35 @@ OrtStatusPtr string_join(const ortc::Tensor<std::string>& input_X,
                  int64_t axis,
                  ortc::Tensor<std::string>& output);
 
-OrtStatusPtr string_length(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_length(const ortc::Tensor<std::string_view>& input,
                    ortc::Tensor<int64_t>& output);
 
-OrtStatusPtr string_lower(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_lower(const ortc::Tensor<std::string_view>& input,
                   ortc::Tensor<std::string>& output);
 
-OrtStatusPtr string_upper(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_upper(const ortc::Tensor<std::string_view>& input,
                   ortc::Tensor<std::string>& output);
 
-OrtStatusPtr string_split(const ortc::Tensor<std::string>& input_X,
+OrtStatusPtr string_split(const ortc::Tensor<std::string_view>& input_X,
                   std::string_view sep,
                   bool skip_empty,
                   ortc::Tensor<int64_t>& out_indices,
                   ortc::Tensor<std::string>& out_text,
-                  ortc::Tensor<int64_t>& out_shape);
+                  ortc::Tensor<int64_t>& out_shape,
+                  ortc::ComputeArena& arena);
 
 OrtStatusPtr string_strip(const ortc::Tensor<std::string>& input,
                   ortc::Tensor<std::string>& output);
 
-OrtStatusPtr string_equal(const ortc::Tensor<std::string>& input_1,
-                                const ortc::Tensor<std::string>& input_2,
-                                ortc::Tensor<bool>& output);
+OrtStatusPtr string_equal(const ortc::Tensor<std::string_view>& input_1,
+                          const ortc::Tensor<std::string_view>& input_2,
+                          ortc::Tensor<bool>& output);
 
-OrtStatusPtr string_hash(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_hash(const ortc::Tensor<std::string_view>& input,
                  int64_t num_buckets,
                  ortc::Tensor<int64_t>& output);
 
-OrtStatusPtr string_hash_fast(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_hash_fast(const ortc::Tensor<std::string_view>& input,
                       int64_t num_buckets,
                       ortc::Tensor<int64_t>& output);
 
@@ -2,47 +2,93 @@
 // Licensed under the MIT License.
 
 #include <vector>
-#include <cmath>
-#include <algorithm>
 #include "farmhash.h"
 #include "string_tensor.h"
 #include "string_functions.h"
+#include "string_hash.hpp"
+#include "fast_modulo.h"
+#include "thread_pool.h"
 
-OrtStatusPtr string_hash(const ortc::Tensor<std::string>& input,
-                 int64_t num_buckets,
-                 ortc::Tensor<int64_t>& output) {
-  // Setup inputs
-  auto& str_input = input.Data();
-
-  // Setup output
-  auto& dimensions = input.Shape();
-  int64_t* out = output.Allocate(dimensions);
+namespace {
 
-  size_t size = output.NumberOfElement();
+// strings hashed by one task of the thread pool.
+constexpr size_t kHashGrain = 1024;
 
-  // Do computation
-  size_t nb = static_cast<size_t>(num_buckets);
-  for (size_t i = 0; i < size; i++) {
-    out[i] = static_cast<int64_t>(Hash64(str_input[i].c_str(), str_input[i].size()) % nb);
+template <typename HashFn>
+OrtStatusPtr HashToBuckets(const char* op_name,
+                           const ortc::Tensor<std::string_view>& input,
+                           int64_t num_buckets,
+                           ortc::Tensor<int64_t>& output,
+                           HashFn hash) {
+  if (num_buckets <= 0) {
+    return OrtW::CreateStatus(MakeString("[", op_name, "]: num_buckets must be positive, got ", num_buckets, "."),
+                              ORT_INVALID_ARGUMENT);
   }
 
+  const auto& str_input = input.Data();
+  int64_t* out = output.Allocate(input.Shape());
+  const ort_extensions::FastModulo bucket_of(static_cast<uint64_t>(num_buckets));
+  ort_extensions::ParallelFor(str_input.size(), kHashGrain, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      out[i] = static_cast<int64_t>(bucket_of(hash(str_input[i])));
+    }
+  });
+
   return nullptr;
 }
 
-OrtStatusPtr string_hash_fast(const ortc::Tensor<std::string>& input,
+}  // namespace
+
+OrtStatusPtr string_hash(const ortc::Tensor<std::string_view>& input,
+                 int64_t num_buckets,
+                 ortc::Tensor<int64_t>& output) {
+  return HashToBuckets("StringToHashBucket", input, num_buckets, output,
+                       [](std::string_view str) { return Hash64(str.data(), str.size()); });
+}
+
+OrtStatusPtr string_hash_fast(const ortc::Tensor<std::string_view>& input,
                       int64_t num_buckets,
                       ortc::Tensor<int64_t>& output) {
-  // Setup inputs
-  auto& str_input = input.Data();
-  // Setup output
-  auto& dimensions = input.Shape();
-  int64_t* out = output.Allocate(dimensions);
-  size_t size = output.NumberOfElement();
-  // Do computation
-  size_t nb = static_cast<size_t>(num_buckets);
-  for (size_t i = 0; i < size; i++) {
-    out[i] = static_cast<int64_t>(util::Fingerprint64(str_input[i].c_str(), str_input[i].size()) % nb);
+  return HashToBuckets("StringToHashBucketFast", input, num_buckets, output,
+                       [](std::string_view str) { return util::Fingerprint64(str.data(), str.size()); });
+}
+
+OrtStatusPtr KernelStringHashMultiSeed::OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "seeds", seeds_));
+  if (seeds_.empty()) {
+    return OrtW::CreateStatus("[StringToHashBucketMultiSeed]: attribute 'seeds' must not be empty.",
+                              ORT_INVALID_ARGUMENT);
+  }
+
+  return nullptr;
+}
+
+OrtStatusPtr KernelStringHashMultiSeed::Compute(const ortc::Tensor<std::string_view>& input,
+                                                int64_t num_buckets,
+                                                ortc::Tensor<int64_t>& output) const {
+  if (num_buckets <= 0) {
+    return OrtW::CreateStatus(
+        MakeString("[StringToHashBucketMultiSeed]: num_buckets must be positive, got ", num_buckets, "."),
+        ORT_INVALID_ARGUMENT);
   }
 
+  const auto& str_input = input.Data();
+  std::vector<int64_t> dimensions(input.Shape());
+  dimensions.push_back(static_cast<int64_t>(seeds_.size()));
+  int64_t* out = output.Allocate(dimensions);
+
+  // all the hashes of a string are computed while it is in cache, and written next to each other.
+  const size_t num_seeds = seeds_.size();
+  const ort_extensions::FastModulo bucket_of(static_cast<uint64_t>(num_buckets));
+  ort_extensions::ParallelFor(str_input.size(), kHashGrain / num_seeds + 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      auto str = str_input[i];
+      int64_t* row = out + i * num_seeds;
+      for (size_t k = 0; k < num_seeds; ++k) {
+        row[k] = static_cast<int64_t>(bucket_of(Hash64(str.data(), str.size(), static_cast<uint64_t>(seeds_[k]))));
+      }
+    }
+  });
+
   return nullptr;
 }
@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ocos.h"
+#include "string_utils.h"
+
+// Hashes every string once per seed of the 'seeds' attribute, for count-min sketch or bloom filter features.
+// The output has the shape of the input plus a last dimension of len(seeds). Each hash is the one of
+// StringToHashBucket with another seed: 0xDECAFCAFFE reproduces StringToHashBucket.
+struct KernelStringHashMultiSeed {
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info);
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
+                       int64_t num_buckets,
+                       ortc::Tensor<int64_t>& output) const;
+
+ private:
+  std::vector<int64_t> seeds_;
+};
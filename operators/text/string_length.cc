@@ -3,13 +3,11 @@
 
 #include "string_functions.h"
 #include "string_tensor.h"
-#include <vector>
-#include <locale>
-#include <codecvt>
-#include <algorithm>
-#include "ustring.h"
+#include "utf8.h"
+#include "thread_pool.h"
+#include <atomic>
 
-OrtStatusPtr string_length(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_length(const ortc::Tensor<std::string_view>& input,
                    ortc::Tensor<int64_t>& output) {
   // Setup inputs
   auto& input_data = input.Data();
@@ -17,8 +15,20 @@ OrtStatusPtr string_length(const ortc::Tensor<std::string>& input,
   auto& dimensions = input.Shape();
   auto* output_data = output.Allocate(dimensions);
 
-  for (int i = 0; i < input.NumberOfElement(); i++) {
-    output_data[i] = ustring(input_data[i]).size();
+  // the code points are counted on the UTF-8 bytes, once they are known to be well-formed.
+  std::atomic<bool> valid{true};
+  ort_extensions::ParallelFor(input_data.size(), 256, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      auto str = input_data[i];
+      if (!ort_extensions::ValidateUTF8(str.data(), str.size())) {
+        valid = false;
+        continue;
+      }
+      output_data[i] = static_cast<int64_t>(ort_extensions::CountUTF8CodePoints(str.data(), str.size()));
+    }
+  });
+  if (!valid) {
+    return OrtW::CreateStatus("[StringLength]: input is not valid UTF-8.", ORT_INVALID_ARGUMENT);
   }
 
   return nullptr;
@@ -3,26 +3,38 @@
 
 #include "string_functions.h"
 #include "string_tensor.h"
-#include "ustring.h"
-#include <vector>
-#include <cmath>
-#include <algorithm>
-#include <iterator>
+#include "case_map.h"
+#include "thread_pool.h"
+#include <atomic>
 
-OrtStatusPtr string_lower(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_lower(const ortc::Tensor<std::string_view>& input,
                   ortc::Tensor<std::string>& output) {
   const auto& input_strings = input.Data();
+  size_t n = input_strings.size();
 
-  std::vector<std::string> output_strings;
-  output_strings.reserve(input_strings.size());
+  // the case mapping keeps the byte length, so the output is laid out first and the rows are converted in place.
+  ortc::StringTensorBuilder output_strings;
+  size_t num_bytes = 0;
+  for (size_t i = 0; i < n; ++i) {
+    num_bytes += input_strings[i].size();
+  }
+  output_strings.Reserve(n, num_bytes);
+  for (size_t i = 0; i < n; ++i) {
+    output_strings.AppendUninitialized(input_strings[i].size());
+  }
 
-  std::transform(input_strings.begin(), input_strings.end(), std::back_inserter(output_strings),
-                 [](const std::string& input_string) {
-                   ustring u32_input_string(input_string);
-                   std::transform(u32_input_string.begin(), u32_input_string.end(), u32_input_string.begin(),
-                                  [](char32_t c) { return ToLower(c); });
-                   return static_cast<std::string>(u32_input_string);
-                 });
+  std::atomic<bool> valid{true};
+  ort_extensions::ParallelFor(n, 64, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      auto str = input_strings[i];
+      if (!ort_extensions::LowerCaseUTF8(str.data(), str.size(), output_strings.MutableElement(i))) {
+        valid = false;
+      }
+    }
+  });
+  if (!valid) {
+    return OrtW::CreateStatus("[StringLower]: input is not valid UTF-8.", ORT_INVALID_ARGUMENT);
+  }
 
   output.SetStringOutput(output_strings, input.Shape());
   return nullptr;
@@ -4,9 +4,6 @@
 #include "string_mapping.hpp"
 #include "string_tensor.h"
 #include <vector>
-#include <locale>
-#include <codecvt>
-#include <algorithm>
 
 OrtStatusPtr KernelStringMapping::OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
   std::string map;
@@ -16,6 +13,8 @@ OrtStatusPtr KernelStringMapping::OnModelAttach(const OrtApi& api, const OrtKern
   }
 
   auto lines = SplitString(map, "\n", true);
+  std::vector<std::string_view> keys;
+  keys.reserve(lines.size());
   for (const auto& line : lines) {
     auto items = SplitString(line, "\t", true);
 
@@ -24,23 +23,24 @@ OrtStatusPtr KernelStringMapping::OnModelAttach(const OrtApi& api, const OrtKern
           ("[StringMapping]: Should only exist two items in one line, find error in line: " + std::string(line)).c_str(),
           ORT_INVALID_GRAPH);
     }
-    map_[std::string(items[0])] = std::string(items[1]);
+    keys.push_back(items[0]);
+    values_.Append(items[1]);
   }
+  keys_ = ort_extensions::PerfectHashTable(keys);
 
   return nullptr;
 }
 
-OrtStatusPtr KernelStringMapping::Compute(const ortc::Tensor<std::string>& input,
+OrtStatusPtr KernelStringMapping::Compute(const ortc::Tensor<std::string_view>& input,
                                           ortc::Tensor<std::string>& output) const {
-  // make a copy as input is constant
-  std::vector<std::string> input_data = input.Data();
+  auto& input_data = input.Data();
 
-  for (auto& str : input_data) {
-    auto entry = map_.find(str);
-    if (entry != map_.end()) {
-      str = entry->second;
-    }
+  ortc::StringTensorBuilder output_data;
+  output_data.Reserve(input_data.size(), 0);
+  for (auto str : input_data) {
+    size_t id = keys_.Find(str);
+    output_data.Append(id == ort_extensions::PerfectHashTable::kNotFound ? str : values_[id]);
   }
-  output.SetStringOutput(input_data, input.Shape());
+  output.SetStringOutput(output_data, input.Shape());
   return nullptr;
 }
@@ -5,14 +5,15 @@
 
 #include "ocos.h"
 #include "string_utils.h"
-#include <unordered_map>
+#include "perfect_hash.h"
 
 struct KernelStringMapping {
 
   OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info);
-  OrtStatusPtr Compute(const ortc::Tensor<std::string>& input,
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
                ortc::Tensor<std::string>& output) const;
 
  private:
-  std::unordered_map<std::string, std::string> map_;
+  ort_extensions::PerfectHashTable keys_;
+  ort_extensions::StringBlob values_;  // indexed by the line of the key
 };
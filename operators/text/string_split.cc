@@ -3,13 +3,15 @@
 
 #include "string_functions.h"
 #include "string_tensor.h"
+#include "string_split.hpp"
 
-OrtStatusPtr string_split(const ortc::Tensor<std::string>& input_X,
+OrtStatusPtr string_split(const ortc::Tensor<std::string_view>& input_X,
                   std::string_view sep,
                   bool skip_empty,
                   ortc::Tensor<int64_t>& out_indices,
                   ortc::Tensor<std::string>& out_text,
-                  ortc::Tensor<int64_t>& out_shape) {
+                  ortc::Tensor<int64_t>& out_shape,
+                  ortc::ComputeArena& arena) {
   // Setup inputs
   auto& X = input_X.Data();
 
@@ -21,62 +23,44 @@ OrtStatusPtr string_split(const ortc::Tensor<std::string>& input_X,
     return status;
   }
 
-  std::vector<std::string> words;
-  std::vector<int64_t> indices;
+  // one scan over the input collects the pieces as spans, so the outputs are allocated once with their final size.
+  ort_extensions::ByteSet separators(sep);
+  ortc::ArenaAllocator<int64_t> allocator(arena);
+  ortc::ArenaVector<int64_t> spans(allocator);
+  ortc::ArenaVector<int64_t> row_counts(allocator);
+  row_counts.resize(X.size());
   int64_t maxc = 0;
-  int64_t col;
-  if (sep.size() == 0) {
-    char word[2] = "a";
-    for (int64_t row = 0; row < dimensions[0]; ++row) {
-      const std::string& str = X[static_cast<size_t>(row)];
-      if (str.empty())
-        continue;
-      maxc = static_cast<int64_t>(static_cast<int64_t>(str.size()) > maxc ? str.size() : maxc);
-      for (auto it = str.begin(); it != str.end(); ++it) {
-        word[0] = *it;
-        words.push_back(word);
-        indices.push_back(row);
-        indices.push_back(std::distance(str.begin(), it));
-      }
-    }
-  } else {
-    bool keep = !skip_empty;
-    std::size_t current, previous = 0;
-    for (int64_t row = 0; row < dimensions[0]; ++row) {
-      const std::string& str = X[static_cast<size_t>(row)];
-      if (str.empty())
-        continue;
-      previous = 0;
-      col = 0;
-      current = str.find_first_of(sep);
-      while (current != std::string::npos) {
-        if (keep || current > previous) {
-          words.push_back(str.substr(previous, current - previous));
-          indices.push_back(row);
-          indices.push_back(col);
-          ++col;
-        }
-        previous = current + 1;
-        current = str.find_first_of(sep, previous);
-      }
-      current = str.size();
-      if (keep || current > previous) {
-        words.push_back(str.substr(previous, current - previous));
-        indices.push_back(row);
-        indices.push_back(col);
-        ++col;
-      }
-      maxc = col > maxc ? col : maxc;
+  size_t num_bytes = 0;
+  for (size_t row = 0; row < X.size(); ++row) {
+    std::string_view str = X[row];
+    if (str.empty())
+      continue;
+    size_t first = spans.size();
+    row_counts[row] = ort_extensions::SplitRow(str, sep.empty() ? nullptr : &separators, !skip_empty, spans);
+    maxc = row_counts[row] > maxc ? row_counts[row] : maxc;
+    for (size_t k = first; k < spans.size(); k += 2) {
+      num_bytes += static_cast<size_t>(spans[k + 1]);
     }
   }
 
-  std::vector<int64_t> shape_indices = {static_cast<int64_t>(indices.size()) / 2, 2};
+  size_t num_pieces = spans.size() / 2;
+  ortc::StringTensorBuilder words;
+  words.Reserve(num_pieces, num_bytes);
+  std::vector<int64_t> shape_indices = {static_cast<int64_t>(num_pieces), 2};
   int64_t* p_indices = out_indices.Allocate(shape_indices);
+  const int64_t* span = spans.data();
+  for (size_t row = 0; row < X.size(); ++row) {
+    std::string_view str = X[row];
+    for (int64_t col = 0; col < row_counts[row]; ++col, span += 2) {
+      words.Append(str.substr(static_cast<size_t>(span[0]), static_cast<size_t>(span[1])));
+      *p_indices++ = static_cast<int64_t>(row);
+      *p_indices++ = col;
+    }
+  }
+
   std::vector<int64_t> shape_text(1, words.size());
   std::vector<int64_t> shape_shape(1, 2);
   int64_t* p_shape = out_shape.Allocate(shape_shape);
-
-  memcpy(p_indices, indices.data(), indices.size() * sizeof(int64_t));
   p_shape[0] = dimensions[0];
   p_shape[1] = maxc;
   out_text.SetStringOutput(words, shape_text);
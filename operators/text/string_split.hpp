@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include "byte_set.h"
+#include "utf8.h"
+
+namespace ort_extensions {
+
+// Records the pieces of a row as (begin, length) pairs into spans and returns how many there are.
+// Without separators every UTF-8 character is a piece, otherwise the row is cut at each separator byte.
+// Shared by StringSplit and TextPipeline, so that both cut the strings the same way.
+template <typename Spans>
+int64_t SplitRow(std::string_view str, const ByteSet* separators, bool keep_empty, Spans& spans) {
+  int64_t count = 0;
+  if (separators == nullptr) {
+    size_t pos = 0;
+    while (pos < str.size()) {
+      size_t ascii_end = pos + AsciiPrefixLength(str.data() + pos, str.size() - pos);
+      for (; pos < ascii_end; ++pos, ++count) {
+        spans.push_back(static_cast<int64_t>(pos));
+        spans.push_back(1);
+      }
+      if (pos < str.size()) {
+        size_t length = UTF8CharLength(str.data() + pos, str.size() - pos);
+        spans.push_back(static_cast<int64_t>(pos));
+        spans.push_back(static_cast<int64_t>(length));
+        pos += length;
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  size_t previous = 0;
+  for (;;) {
+    size_t current = separators->FindFirst(str.data(), str.size(), previous);
+    if (keep_empty || current > previous) {
+      spans.push_back(static_cast<int64_t>(previous));
+      spans.push_back(static_cast<int64_t>(current - previous));
+      ++count;
+    }
+    if (current == str.size()) {
+      break;
+    }
+    previous = current + 1;
+  }
+  return count;
+}
+
+}  // namespace ort_extensions
@@ -1,5 +1,5 @@
 #include <charconv>
-#include "farmhash.h"
+#include <cstring>
 #include "string_utils.h"
 #include "string_to_vector.hpp"
 #include "string_tensor.h"
@@ -9,28 +9,15 @@ StringToVectorImpl::StringToVectorImpl(std::string& map, std::string& unk) {
   ParseUnkownValue(unk);
 }
 
-std::vector<std::vector<int64_t>> StringToVectorImpl::Compute(const std::vector<std::string>& str_input,
-                                                              const std::vector<int64_t>& input_dim,
-                                                              std::vector<int64_t>& output_dim) const {
-  std::vector<std::vector<int64_t>> result;
-
-  // Set output dimension
-  output_dim = input_dim;
-  output_dim.push_back(vector_len_);
+const int64_t* StringToVectorImpl::Lookup(std::string_view str) const {
+  size_t id = keys_.Find(str);
+  return id == ort_extensions::PerfectHashTable::kNotFound ? unk_value_.data() : values_.data() + id * vector_len_;
+}
 
-  std::string key;
+void StringToVectorImpl::Compute(const ortc::StringViews& str_input, int64_t* output) const {
   for (size_t i = 0; i < str_input.size(); i++) {
-    key = str_input[i];
-
-    auto it = map_.find(key);
-    if (it != map_.end()) {
-      result.push_back(it->second);
-    } else {
-      result.push_back(unk_value_);
-    }
+    std::memcpy(output + i * vector_len_, Lookup(str_input[i]), vector_len_ * sizeof(int64_t));
   }
-
-  return result;
 }
 
 void StringToVectorImpl::ParseMappingTable(std::string& map) {
@@ -46,20 +33,22 @@ void StringToVectorImpl::ParseMappingTable(std::string& map) {
                        ORT_INVALID_ARGUMENT);
   }
 
-  std::vector<int64_t> values(vector_len_);
-  for (auto& line : lines) {
-    auto kv = SplitString(line, "\t", true);
+  std::vector<std::string_view> keys;
+  keys.reserve(lines.size());
+  values_.resize(lines.size() * vector_len_);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    auto kv = SplitString(lines[i], "\t", true);
 
     if (kv.size() != 2) {
-      ORTX_CXX_API_THROW(MakeString("Failed to parse mapping_table when processing the line: ", line),
+      ORTX_CXX_API_THROW(MakeString("Failed to parse mapping_table when processing the line: ", lines[i]),
                          ORT_INVALID_ARGUMENT);
     }
 
-    ParseValues(kv[1], values);
-
-    // string to vector mapping
-    map_[std::string{kv[0]}] = values;
+    // string to vector mapping, the vectors are the rows of one matrix
+    keys.push_back(kv[0]);
+    ParseValues(kv[1], values_.data() + i * vector_len_);
   }
+  keys_ = ort_extensions::PerfectHashTable(keys);
 }
 
 void StringToVectorImpl::ParseUnkownValue(std::string& unk) {
@@ -94,8 +83,13 @@ size_t StringToVectorImpl::ParseVectorLen(const std::string_view& line) {
   return value_strs.size();
 }
 
-void StringToVectorImpl::ParseValues(const std::string_view& v, std::vector<int64_t>& values) {
+void StringToVectorImpl::ParseValues(const std::string_view& v, int64_t* values) {
   std::vector<std::string_view> value_strs = SplitString(v, " ", true);
+  if (value_strs.size() != vector_len_) {
+    ORTX_CXX_API_THROW(MakeString("Incompatible dimension: required vector length should be ", vector_len_,
+                                  ", but the mapped value is: ", v),
+                       ORT_INVALID_ARGUMENT);
+  }
 
   int64_t value;
   for (size_t i = 0; i < value_strs.size(); i++) {
@@ -122,24 +116,14 @@ OrtStatusPtr KernelStringToVector::OnModelAttach(const OrtApi& api, const OrtKer
   return status;
 }
 
-OrtStatusPtr KernelStringToVector::Compute(const ortc::Tensor<std::string>& input,
+OrtStatusPtr KernelStringToVector::Compute(const ortc::Tensor<std::string_view>& input,
                                            ortc::Tensor<int64_t>& out) const {
-  // Setup input
-  auto& input_data = input.Data();
-  // Get output
-  std::vector<int64_t> output_dim;
-  auto mapping_result = impl_->Compute(input_data, input.Shape(), output_dim);
+  // Set output dimension
+  std::vector<int64_t> output_dim = input.Shape();
+  output_dim.push_back(impl_->VectorLength());
 
   auto* output_data = out.Allocate(output_dim);
-
-  // Set output tensor data
-  int idx = 0;
-  for (auto& res : mapping_result) {
-    for (int64_t value : res) {
-      output_data[idx] = value;
-      idx++;
-    }
-  }
+  impl_->Compute(input.Data(), output_data);
 
   return nullptr;
 }
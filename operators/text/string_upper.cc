@@ -3,19 +3,31 @@
 
 #include "string_functions.h"
 #include "string_tensor.h"
-#include <vector>
-#include <cmath>
-#include <algorithm>
+#include "case_map.h"
+#include "thread_pool.h"
 
-OrtStatusPtr string_upper(const ortc::Tensor<std::string>& input,
+OrtStatusPtr string_upper(const ortc::Tensor<std::string_view>& input,
                   ortc::Tensor<std::string>& output) {
   // Setup inputs
-  std::vector<std::string> X = input.Data();
+  const auto& X = input.Data();
+  size_t n = X.size();
 
-  for (size_t i = 0; i < X.size(); ++i) {
-    std::transform(X[i].begin(), X[i].end(), X[i].begin(), [](char c) { return static_cast<char>(::toupper(c)); });
+  ortc::StringTensorBuilder Y;
+  size_t num_bytes = 0;
+  for (size_t i = 0; i < n; ++i) {
+    num_bytes += X[i].size();
   }
+  Y.Reserve(n, num_bytes);
+  for (size_t i = 0; i < n; ++i) {
+    Y.AppendUninitialized(X[i].size());
+  }
+
+  ort_extensions::ParallelFor(n, 64, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      ort_extensions::UpperCaseAscii(X[i].data(), X[i].size(), Y.MutableElement(i));
+    }
+  });
 
-  output.SetStringOutput(X, input.Shape());
+  output.SetStringOutput(Y, input.Shape());
   return nullptr;
 }
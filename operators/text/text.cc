@@ -5,6 +5,8 @@
 #include "text/string_ecmaregex_replace.hpp"
 #include "text/string_ecmaregex_split.hpp"
 #include "text/string_mapping.hpp"
+#include "text/string_hash.hpp"
+#include "text/text_pipeline.hpp"
 
 #if defined(ENABLE_RE2_REGEX)
 #include "text/re2_strings/string_regex.h"
@@ -23,6 +25,7 @@ FxLoadCustomOpFactory LoadCustomOpClasses_Text = []()-> CustomOpArray& {
       CustomCpuFuncV2("StringEqual", string_equal),
       CustomCpuFuncV2("StringToHashBucket", string_hash),
       CustomCpuFuncV2("StringToHashBucketFast", string_hash_fast),
+      CustomCpuStructV2("StringToHashBucketMultiSeed", KernelStringHashMultiSeed),
       CustomCpuFuncV2("StringJoin", string_join),
       CustomCpuFuncV2("StringLower", string_lower),
       CustomCpuFuncV2("StringUpper", string_upper),
@@ -33,6 +36,7 @@ FxLoadCustomOpFactory LoadCustomOpClasses_Text = []()-> CustomOpArray& {
       CustomCpuFuncV2("StringConcat", string_concat),
       CustomCpuStructV2("StringMapping", KernelStringMapping),
       CustomCpuStructV2("StringToVector", KernelStringToVector),
+      CustomCpuStructV2("TextPipeline", KernelTextPipeline),
       CustomCpuStructV2("VectorToString", KernelVectorToString),
       CustomCpuStructV2("StringECMARegexReplace", KernelStringECMARegexReplace),
       CustomCpuStructV2("StringECMARegexSplitWithOffsets", KernelStringECMARegexSplitWithOffsets));
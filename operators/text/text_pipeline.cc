@@ -0,0 +1,209 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include "farmhash.h"
+#include "text_pipeline.hpp"
+#include "string_split.hpp"
+#include "case_map.h"
+#include "thread_pool.h"
+
+#if defined(ENABLE_RE2_REGEX)
+#include "re2_strings/re2_cache.h"
+#endif  // ENABLE_RE2_REGEX
+
+namespace {
+
+// rows transformed by one task of the thread pool.
+constexpr size_t kRowGrain = 16;
+
+}  // namespace
+
+struct KernelTextPipeline::Scratch {
+  std::string text;
+  std::vector<int64_t> spans;
+};
+
+OrtStatusPtr KernelTextPipeline::OnModelAttach(const OrtApi& api, const OrtKernelInfo& info) {
+  std::string steps, mapping{"hash"}, sep{" "}, map, unk;
+  int64_t skip_empty = 0;
+  int64_t num_buckets = 0;
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "steps", steps));
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "sep", sep));
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "skip_empty", skip_empty));
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "mapping", mapping));
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "num_buckets", num_buckets));
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "map", map));
+  ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "unk", unk));
+
+  for (auto step : SplitString(steps, ", ", true)) {
+    if (split_) {
+      return OrtW::CreateStatus("[TextPipeline]: 'split' must be the last of the steps.", ORT_INVALID_ARGUMENT);
+    }
+    if (step == "lower") {
+      steps_.push_back(Step::kLower);
+    } else if (step == "regex_replace") {
+      steps_.push_back(Step::kRegexReplace);
+    } else if (step == "split") {
+      split_ = true;
+    } else {
+      return OrtW::CreateStatus(MakeString("[TextPipeline]: unknown step '", step, "'."), ORT_INVALID_ARGUMENT);
+    }
+  }
+  skip_empty_ = skip_empty != 0;
+  if (!sep.empty()) {
+    separators_ = std::make_shared<ort_extensions::ByteSet>(sep);
+  }
+
+  if (std::find(steps_.begin(), steps_.end(), Step::kRegexReplace) != steps_.end()) {
+#if defined(ENABLE_RE2_REGEX)
+    std::string pattern;
+    int64_t global_replace = 1;
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "regex_pattern", pattern));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "regex_rewrite", regex_rewrite_));
+    ORTX_RETURN_IF_ERROR(OrtW::GetOpAttribute(info, "regex_global_replace", global_replace));
+    if (pattern.empty()) {
+      return OrtW::CreateStatus("[TextPipeline]: regex_pattern cannot be empty.", ORT_INVALID_ARGUMENT);
+    }
+    regex_ = ort_extensions::RE2Cache::ProcessWide().Get(pattern);
+    if (!regex_->ok()) {
+      return OrtW::CreateStatus(MakeString("[TextPipeline]: invalid regex_pattern: ", regex_->error()),
+                                ORT_INVALID_ARGUMENT);
+    }
+    regex_global_replace_ = global_replace != 0;
+#else
+    return OrtW::CreateStatus("[TextPipeline]: the regex_replace step needs a build with RE2.",
+                              ORT_INVALID_ARGUMENT);
+#endif  // ENABLE_RE2_REGEX
+  }
+
+  if (mapping == "hash" || mapping == "hash_fast") {
+    mapping_ = mapping == "hash" ? Mapping::kHash : Mapping::kHashFast;
+    if (num_buckets <= 0) {
+      return OrtW::CreateStatus("[TextPipeline]: num_buckets must be positive.", ORT_INVALID_ARGUMENT);
+    }
+    bucket_of_ = ort_extensions::FastModulo(static_cast<uint64_t>(num_buckets));
+  } else if (mapping == "lookup") {
+    mapping_ = Mapping::kLookup;
+    vocabulary_ = std::make_shared<StringToVectorImpl>(map, unk);
+    if (vocabulary_->VectorLength() != 1) {
+      return OrtW::CreateStatus("[TextPipeline]: the lookup map must have a single value per key.",
+                                ORT_INVALID_ARGUMENT);
+    }
+  } else {
+    return OrtW::CreateStatus(MakeString("[TextPipeline]: unknown mapping '", mapping, "'."), ORT_INVALID_ARGUMENT);
+  }
+
+  return nullptr;
+}
+
+bool KernelTextPipeline::ProcessRow(std::string_view str, Scratch& scratch, std::vector<int64_t>& ids) const {
+  // the steps after the first one work in place on the scratch string.
+  std::string_view text = str;
+  for (auto step : steps_) {
+    switch (step) {
+      case Step::kLower:
+        scratch.text.resize(text.size());
+        if (!ort_extensions::LowerCaseUTF8(text.data(), text.size(), &scratch.text[0])) {
+          return false;
+        }
+        break;
+      case Step::kRegexReplace:
+#if defined(ENABLE_RE2_REGEX)
+        if (text.data() != scratch.text.data()) {
+          scratch.text.assign(text);
+        }
+        if (regex_global_replace_) {
+          re2::RE2::GlobalReplace(&scratch.text, *regex_, regex_rewrite_);
+        } else {
+          re2::RE2::Replace(&scratch.text, *regex_, regex_rewrite_);
+        }
+#endif  // ENABLE_RE2_REGEX
+        break;
+    }
+    text = scratch.text;
+  }
+
+  auto append_id = [&](std::string_view piece) {
+    switch (mapping_) {
+      case Mapping::kHash:
+        ids.push_back(static_cast<int64_t>(bucket_of_(Hash64(piece.data(), piece.size()))));
+        break;
+      case Mapping::kHashFast:
+        ids.push_back(static_cast<int64_t>(bucket_of_(util::Fingerprint64(piece.data(), piece.size()))));
+        break;
+      case Mapping::kLookup:
+        ids.push_back(*vocabulary_->Lookup(piece));
+        break;
+    }
+  };
+
+  if (!split_) {
+    append_id(text);
+    return true;
+  }
+
+  // as in StringSplit, an empty string has no pieces.
+  if (text.empty()) {
+    return true;
+  }
+  scratch.spans.clear();
+  ort_extensions::SplitRow(text, separators_.get(), !skip_empty_, scratch.spans);
+  for (size_t k = 0; k < scratch.spans.size(); k += 2) {
+    append_id(text.substr(static_cast<size_t>(scratch.spans[k]), static_cast<size_t>(scratch.spans[k + 1])));
+  }
+  return true;
+}
+
+OrtStatusPtr KernelTextPipeline::Compute(const ortc::Tensor<std::string_view>& input,
+                                         ortc::Tensor<int64_t>& ids,
+                                         ortc::Tensor<int64_t>& row_splits) const {
+  if (input.Shape().size() != 1) {
+    return OrtW::CreateStatus("[TextPipeline]: only 1D tensor are supported as input.", ORT_INVALID_ARGUMENT);
+  }
+
+  // each chunk of rows appends its ids to its own buffer, kept at the index of its first row, and records the
+  // row splits relative to that buffer; the buffers are then concatenated in row order.
+  const auto& str_input = input.Data();
+  const size_t n = str_input.size();
+  std::vector<std::vector<int64_t>> chunk_ids(n);
+  std::vector<size_t> chunk_end(n);
+  int64_t* p_splits = row_splits.Allocate({static_cast<int64_t>(n + 1)});
+  p_splits[0] = 0;
+  std::atomic<bool> valid{true};
+  ort_extensions::ParallelFor(n, kRowGrain, [&](size_t begin, size_t end) {
+    Scratch scratch;
+    auto& buffer = chunk_ids[begin];
+    chunk_end[begin] = end;
+    for (size_t i = begin; i < end; ++i) {
+      if (!ProcessRow(str_input[i], scratch, buffer)) {
+        valid = false;
+      }
+      p_splits[i + 1] = static_cast<int64_t>(buffer.size());
+    }
+  });
+  if (!valid) {
+    return OrtW::CreateStatus("[TextPipeline]: input is not valid UTF-8.", ORT_INVALID_ARGUMENT);
+  }
+
+  int64_t total = 0;
+  for (size_t begin = 0; begin < n; begin = chunk_end[begin]) {
+    for (size_t i = begin; i < chunk_end[begin]; ++i) {
+      p_splits[i + 1] += total;
+    }
+    total += static_cast<int64_t>(chunk_ids[begin].size());
+  }
+
+  int64_t* p_ids = ids.Allocate({total});
+  for (size_t begin = 0; begin < n; begin = chunk_end[begin]) {
+    const auto& buffer = chunk_ids[begin];
+    if (!buffer.empty()) {
+      std::memcpy(p_ids, buffer.data(), buffer.size() * sizeof(int64_t));
+      p_ids += buffer.size();
+    }
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "ocos.h"
+#include "string_utils.h"
+#include "byte_set.h"
+#include "fast_modulo.h"
+#include "string_to_vector.hpp"
+
+#if defined(ENABLE_RE2_REGEX)
+#include "re2/re2.h"
+#endif  // ENABLE_RE2_REGEX
+
+// Runs a chain of the text kernels on every string of a 1D tensor in one pass and outputs the ids of the pieces as
+// a ragged tensor, without materializing the intermediate string tensors. The results are the ones of the unfused
+// chain StringLower -> StringRegexReplace -> StringSplit -> StringToHashBucket(Fast) or StringToVector.
+//
+// Attributes:
+//   steps: the transforms to apply, in order, separated by commas: "lower", "regex_replace" and "split".
+//          "split" comes last if present; without it, every string is a single piece.
+//   regex_pattern, regex_rewrite, regex_global_replace: the settings of the StringRegexReplace step.
+//   sep, skip_empty: the settings of the StringSplit step.
+//   mapping: how a piece becomes an id, "hash" (StringToHashBucket), "hash_fast" (StringToHashBucketFast)
+//            or "lookup" (StringToVector with one value per key).
+//   num_buckets: the number of buckets of the hash mappings.
+//   map, unk: the vocabulary and the unknown id of the lookup mapping, in the StringToVector format.
+// Outputs:
+//   ids: the ids of all the pieces, row after row.
+//   row_splits: the N + 1 offsets of the rows in ids.
+struct KernelTextPipeline {
+  OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info);
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
+                       ortc::Tensor<int64_t>& ids,
+                       ortc::Tensor<int64_t>& row_splits) const;
+
+  enum class Step { kLower, kRegexReplace };
+  enum class Mapping { kHash, kHashFast, kLookup };
+
+ private:
+  struct Scratch;
+  // Transforms one string and appends the ids of its pieces; returns false if it is not valid UTF-8.
+  bool ProcessRow(std::string_view str, Scratch& scratch, std::vector<int64_t>& ids) const;
+
+  std::vector<Step> steps_;
+  bool split_{};
+  std::shared_ptr<ort_extensions::ByteSet> separators_;  // null to split into UTF-8 characters
+  bool skip_empty_{};
+  Mapping mapping_{Mapping::kHash};
+  ort_extensions::FastModulo bucket_of_{1};
+  std::shared_ptr<StringToVectorImpl> vocabulary_;
+#if defined(ENABLE_RE2_REGEX)
+  std::shared_ptr<const re2::RE2> regex_;
+  std::string regex_rewrite_;
+  bool regex_global_replace_{true};
+#endif  // ENABLE_RE2_REGEX
+};
@@ -1,28 +1,17 @@
 #include <charconv>
-#include "farmhash.h"
+#include <numeric>
 #include "string_utils.h"
 #include "vector_to_string.hpp"
 #include "string_tensor.h"
 
-namespace std {
-
-template <class T>
-size_t hash<std::vector<T>>::operator()(const vector<T>& __vector) const noexcept {
-  return util::Hash(reinterpret_cast<const char*>(__vector.data()), __vector.size() * sizeof(T));
-}
-
-template struct hash<std::vector<std::string>>;
-}  // namespace std
-
 VectorToStringImpl::VectorToStringImpl(std::string& map, std::string& unk) : unk_value_(unk) {
   ParseMappingTable(map);
 }
 
-std::vector<std::string> VectorToStringImpl::Compute(const void* input,
-                                                     const std::vector<int64_t>& input_dim,
-                                                     std::vector<int64_t>& output_dim) const {
-  std::vector<std::string> result;
-
+void VectorToStringImpl::Compute(const void* input,
+                                 const std::vector<int64_t>& input_dim,
+                                 std::vector<int64_t>& output_dim,
+                                 ortc::StringTensorBuilder& result) const {
   const int64_t* ptr = static_cast<const int64_t*>(input);
 
   if (vector_len_ == 1 && (input_dim.size() == 1 || input_dim.empty())) {
@@ -38,25 +27,18 @@ std::vector<std::string> VectorToStringImpl::Compute(const void* input,
     output_dim.pop_back();
   }
 
-  std::vector<int64_t> key(vector_len_);
   int64_t input_element_size = std::accumulate(input_dim.begin(), input_dim.end(), 1ULL, std::multiplies<int64_t>());
+  if (vector_len_ > 0) {
+    result.Reserve(static_cast<size_t>(input_element_size) / vector_len_, 0);
+  }
   for (int64_t i = 0; i < input_element_size; i = static_cast<int64_t>(i + vector_len_)) {
-    // construct key
-    for (size_t j = 0; j < vector_len_; j++) {
-      key[j] = ptr[j];
-    }
-
-    auto it = map_.find(key);
-    if (it != map_.end()) {
-      result.push_back(it->second);
-    } else {
-      result.push_back(unk_value_);
-    }
+    // the key is probed in place
+    std::string_view key(reinterpret_cast<const char*>(ptr), vector_len_ * sizeof(int64_t));
+    size_t id = keys_.Find(key);
+    result.Append(id == ort_extensions::PerfectHashTable::kNotFound ? std::string_view(unk_value_) : values_[id]);
 
     ptr = ptr + vector_len_;
   }
-
-  return result;
 }
 
 void VectorToStringImpl::ParseMappingTable(std::string& map) {
@@ -68,19 +50,26 @@ void VectorToStringImpl::ParseMappingTable(std::string& map) {
 
   vector_len_ = ParseVectorLen(lines[0]);
 
-  std::vector<int64_t> values(vector_len_);
-  for (auto& line : lines) {
-    auto kv = SplitString(line, "\t", true);
+  std::vector<int64_t> key_matrix(lines.size() * vector_len_);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    auto kv = SplitString(lines[i], "\t", true);
 
     if (kv.size() != 2) {
-      ORTX_CXX_API_THROW(MakeString("Failed to parse mapping_table when processing the line: ", line),
+      ORTX_CXX_API_THROW(MakeString("Failed to parse mapping_table when processing the line: ", lines[i]),
                          ORT_INVALID_ARGUMENT);
     }
 
-    ParseValues(kv[1], values);
+    ParseValues(kv[1], key_matrix.data() + i * vector_len_);
+    values_.Append(kv[0]);
+  }
 
-    map_[values] = kv[0];
+  std::vector<std::string_view> keys;
+  keys.reserve(lines.size());
+  for (size_t i = 0; i < lines.size(); ++i) {
+    keys.emplace_back(reinterpret_cast<const char*>(key_matrix.data() + i * vector_len_),
+                      vector_len_ * sizeof(int64_t));
   }
+  keys_ = ort_extensions::PerfectHashTable(keys);
 }
 
 size_t VectorToStringImpl::ParseVectorLen(const std::string_view& line) {
@@ -95,8 +84,13 @@ size_t VectorToStringImpl::ParseVectorLen(const std::string_view& line) {
   return value_strs.size();
 }
 
-void VectorToStringImpl::ParseValues(const std::string_view& v, std::vector<int64_t>& values) {
+void VectorToStringImpl::ParseValues(const std::string_view& v, int64_t* values) {
   std::vector<std::string_view> value_strs = SplitString(v, " ", true);
+  if (value_strs.size() != vector_len_) {
+    ORTX_CXX_API_THROW(MakeString("Incompatible dimension: required vector length should be ", vector_len_,
+                                  ", but the key is: ", v),
+                       ORT_INVALID_ARGUMENT);
+  }
 
   int64_t value;
   for (size_t i = 0; i < value_strs.size(); i++) {
@@ -128,7 +122,8 @@ OrtStatusPtr KernelVectorToString::Compute(const ortc::Tensor<int64_t>& input,
   const void* input_data = input.Data();
 
   std::vector<int64_t> output_dim;
-  std::vector<std::string> mapping_result = impl_->Compute(input_data, input.Shape(), output_dim);
+  ortc::StringTensorBuilder mapping_result;
+  impl_->Compute(input_data, input.Shape(), output_dim, mapping_result);
   out.SetStringOutput(mapping_result, output_dim);
   return nullptr;
 }
@@ -4,34 +4,29 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <vector>
 #include "ocos.h"
 #include "string_utils.h"
-
-namespace std {
-
-template <class T>
-struct hash<std::vector<T>> {
-  size_t operator()(const vector<T>& __vector) const noexcept;
-};
-}  // namespace std
+#include "perfect_hash.h"
 
 class VectorToStringImpl {
  public:
   VectorToStringImpl(std::string& map, std::string& unk);
-  std::vector<std::string> Compute(const void* input,
-                                   const std::vector<int64_t>& input_dim,
-                                   std::vector<int64_t>& output_dim) const;
+  void Compute(const void* input,
+               const std::vector<int64_t>& input_dim,
+               std::vector<int64_t>& output_dim,
+               ortc::StringTensorBuilder& result) const;
 
  private:
   void ParseMappingTable(std::string& map);
   size_t ParseVectorLen(const std::string_view& line);
-  void ParseValues(const std::string_view& v, std::vector<int64_t>& values);
+  void ParseValues(const std::string_view& v, int64_t* values);
 
-  std::unordered_map<std::vector<int64_t>, std::string> map_;
+  // the keys are the bytes of the int64 vectors
+  ort_extensions::PerfectHashTable keys_;
+  ort_extensions::StringBlob values_;
   std::string unk_value_;
-  size_t vector_len_;
+  size_t vector_len_{};
 };
 
 struct KernelVectorToString {
@@ -95,6 +95,10 @@ KernelBasicTokenizer::KernelBasicTokenizer(const OrtApi& api, const OrtKernelInf
 void KernelBasicTokenizer::Compute(std::string_view input,
                                    ortc::Tensor<std::string>& output) const {
   // Setup inputs
-  std::vector<ustring> result = tokenizer_->Tokenize(ustring(input));
+  ustring decoded;
+  if (!ustring::DecodeUTF8(input, decoded)) {
+    ORTX_CXX_API_THROW("[BasicTokenizer]: input is not valid UTF-8.", ORT_INVALID_ARGUMENT);
+  }
+  std::vector<ustring> result = tokenizer_->Tokenize(decoded);
   output.SetStringOutput({result[0].operator std::string()}, {1});
 }
@@ -304,6 +304,14 @@ TruncateStrategy::TruncateStrategy(std::string_view strategy_name) : strategy_(T
   }
 }
 
+static ustring DecodeInput(const std::string& input) {
+  ustring decoded;
+  if (!ustring::DecodeUTF8(input, decoded)) {
+    ORTX_CXX_API_THROW("[BertTokenizer]: input is not valid UTF-8.", ORT_INVALID_ARGUMENT);
+  }
+  return decoded;
+}
+
 KernelBertTokenizer::KernelBertTokenizer(const OrtApi& api, const OrtKernelInfo& info) : BaseKernel(api, info) {
   std::string vocab = ort_.KernelInfoGetAttribute<std::string>(&info, "vocab_file");
   bool do_lower_case = TryToGetAttributeWithDefault("do_lower_case", true);
@@ -349,14 +357,14 @@ void KernelBertTokenizer::Compute(const ortc::Tensor<std::string>& input,
   }
 
   if (input_data.size() == 1) {
-    std::vector<ustring> tokens = tokenizer_->Tokenize(ustring(input_data[0]), offset_map, compute_offset_mapping);
+    std::vector<ustring> tokens = tokenizer_->Tokenize(DecodeInput(input_data[0]), offset_map, compute_offset_mapping);
     std::vector<int64_t> encoded = tokenizer_->Encode(tokens);
     tokenizer_->Truncate(encoded);
     input_ids = tokenizer_->AddSpecialToken(encoded);
     token_type_ids = tokenizer_->GenerateTypeId(encoded);
   } else {
-    std::vector<ustring> tokens1 = tokenizer_->Tokenize(ustring(input_data[0]), offset_map, compute_offset_mapping);
-    std::vector<ustring> tokens2 = tokenizer_->Tokenize(ustring(input_data[1]), offset_map, compute_offset_mapping);
+    std::vector<ustring> tokens1 = tokenizer_->Tokenize(DecodeInput(input_data[0]), offset_map, compute_offset_mapping);
+    std::vector<ustring> tokens2 = tokenizer_->Tokenize(DecodeInput(input_data[1]), offset_map, compute_offset_mapping);
     std::vector<int64_t> encoded1 = tokenizer_->Encode(tokens1);
     std::vector<int64_t> encoded2 = tokenizer_->Encode(tokens2);
     input_ids = tokenizer_->AddSpecialToken(encoded1, encoded2);
@@ -413,8 +421,8 @@ void KernelHfBertTokenizer::Compute(const ortc::Tensor<std::string>& input,
     compute_offset_mapping = true;
   }
 
-  std::vector<ustring> tokens1 = tokenizer_->Tokenize(ustring(input_data[0]), offset_map, compute_offset_mapping);
-  std::vector<ustring> tokens2 = tokenizer_->Tokenize(ustring(input_data[1]), offset_map, compute_offset_mapping);
+  std::vector<ustring> tokens1 = tokenizer_->Tokenize(DecodeInput(input_data[0]), offset_map, compute_offset_mapping);
+  std::vector<ustring> tokens2 = tokenizer_->Tokenize(DecodeInput(input_data[1]), offset_map, compute_offset_mapping);
   std::vector<int64_t> encoded1 = tokenizer_->Encode(tokens1);
   std::vector<int64_t> encoded2 = tokenizer_->Encode(tokens2);
   std::vector<int64_t> input_ids = tokenizer_->AddSpecialToken(encoded1, encoded2);
@@ -157,11 +157,11 @@ void KernelBertTokenizerDecoder::Compute(const ortc::Tensor<int64_t>& ids,
 
   const int64_t* p_positions = positions.NumberOfElement() == 0 ? nullptr : positions.Data();
 
-  std::vector<std::string> result;
+  ortc::StringTensorBuilder result;
   std::vector<int64_t> output_dim(1);
   if (!use_indices_) {
-    result.push_back(decoder_->Decode(std::vector<int64_t>(p_ids, p_ids + ids.NumberOfElement()),
-                                      skip_special_tokens_, clean_up_tokenization_spaces_));
+    result.Append(decoder_->Decode(std::vector<int64_t>(p_ids, p_ids + ids.NumberOfElement()),
+                                   skip_special_tokens_, clean_up_tokenization_spaces_));
     output_dim[0] = 1;
   } else {
     if (p_positions != nullptr) {
@@ -169,8 +169,8 @@ void KernelBertTokenizerDecoder::Compute(const ortc::Tensor<int64_t>& ids,
         int64_t start = p_positions[2 * i];
         int64_t end = p_positions[2 * i + 1];
 
-        result.push_back(decoder_->Decode(std::vector<int64_t>(p_ids + start, p_ids + end),
-                                          skip_special_tokens_, clean_up_tokenization_spaces_));
+        result.Append(decoder_->Decode(std::vector<int64_t>(p_ids + start, p_ids + end),
+                                       skip_special_tokens_, clean_up_tokenization_spaces_));
       }
       output_dim[0] = positions_dim[0];
     }
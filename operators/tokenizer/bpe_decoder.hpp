@@ -126,57 +126,52 @@ struct KernelBpeDecoder {
 
     size_t seq_len = ids_dim.back();
     size_t string_batch = ids.NumberOfElement() / seq_len;
-    std::vector<std::string> decoded_strings;
-    decoded_strings.reserve(string_batch);
+    ortc::StringTensorBuilder decoded_strings;
 
     for (auto n = string_batch; n > 0; n--) {
-      std::string text;
       bool f_special_last = false;
       bool f_special = false;
       auto count = static_cast<size_t>(ids.NumberOfElement());
 
       for (size_t tok_idx = 0; tok_idx < count; ++tok_idx) {
         const auto token = *(p_ids + tok_idx);
-        std::string decoded_token;
         f_special = all_special_ids_.count(token) ? true : false;
         if (skip_special_tokens_ && f_special) {
           f_special_last = f_special;
           continue;
         }
 
-        if (added_tokens_.count(token)) {
-          const std::string ws = added_tokens_.at(token);
-          decoded_token = (std::string)ws;
-        } else if (static_cast<size_t>(token) < arr_vocab_.size()) {
-          const auto str = arr_vocab_[token];
-          for (auto wchr : str) {
-            unsigned char uchr = byte_decoder_.at(wchr);
-            decoded_token.push_back(uchr);
-          }
-        } else {
-          if (skip_special_tokens_) {
-            continue;
-          } else {
-            decoded_token = unk_token_;
-          }
+        auto added_token = added_tokens_.find(token);
+        bool in_vocab = added_token == added_tokens_.end() && static_cast<size_t>(token) < arr_vocab_.size();
+        if (added_token == added_tokens_.end() && !in_vocab && skip_special_tokens_) {
+          continue;
         }
 
         if (whitespace_token_ &&
             f_special && (tok_idx > 0 && !f_special_last)) {
-          text.push_back(' ');
+          decoded_strings.Extend(' ');
         }
 
-        text.append(decoded_token);
+        // the decoded bytes go straight into the output buffer.
+        if (added_token != added_tokens_.end()) {
+          decoded_strings.Extend(added_token->second);
+        } else if (in_vocab) {
+          for (auto wchr : arr_vocab_[token]) {
+            decoded_strings.Extend(static_cast<char>(byte_decoder_.at(wchr)));
+          }
+        } else {
+          decoded_strings.Extend(unk_token_);
+        }
 
         if (whitespace_token_ &&
             f_special && tok_idx != count - 1) {
-          text.push_back(' ');
+          decoded_strings.Extend(' ');
         }
 
         f_special_last = f_special;
       }
 
-      decoded_strings.emplace_back(std::move(text));
+      decoded_strings.EndElement();
       p_ids += seq_len;
     }
     output.SetStringOutput(decoded_strings, output_dim);
@@ -286,12 +286,12 @@ std::vector<int64_t> KernelBpeTokenizer::Tokenize(ustring& input,
   return res;
 }
 
-OrtStatusPtr KernelBpeTokenizer::Compute(const ortc::Tensor<std::string>& input,
+OrtStatusPtr KernelBpeTokenizer::Compute(const ortc::Tensor<std::string_view>& input,
                                          ortc::Tensor<int64_t>& tokenize_output,
                                          std::optional<ortc::Tensor<int64_t>*> attention_mask,
                                          std::optional<ortc::Tensor<int64_t>*> offset_mapping) const {
   // Setup inputs
-  std::vector<std::string> str_input{input.Data()};
+  const auto& str_input = input.Data();
   std::list<OffsetMappingType> offset_map;
   const auto& input_dim = input.Shape();
 
@@ -303,8 +303,11 @@ OrtStatusPtr KernelBpeTokenizer::Compute(const ortc::Tensor<std::string>& input,
     compute_offset_mapping = true;
   }
 
-  for (auto& str : str_input) {
-    ustring ustr = ustring(str);
+  for (auto str : str_input) {
+    ustring ustr;
+    if (!ustring::DecodeUTF8(str, ustr)) {
+      return OrtW::CreateStatus("[BpeTokenizer]: input is not valid UTF-8.", ORT_INVALID_ARGUMENT);
+    }
     tokenize_results.emplace_back(
         Tokenize(
             ustr,
@@ -31,7 +31,7 @@ struct KernelBpeTokenizer {
   KernelBpeTokenizer(const BpeModelConf& conf);
   OrtStatusPtr OnModelAttach(const OrtApi& api, const OrtKernelInfo& info);
 
-  OrtStatusPtr Compute(const ortc::Tensor<std::string>& input,
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
                        ortc::Tensor<int64_t>& tokenize_output,
                        std::optional<ortc::Tensor<int64_t>*> attention_mask,
                        std::optional<ortc::Tensor<int64_t>*> offset_mapping) const;
@@ -59,7 +59,7 @@ struct KernelBpeTokenizer {
 struct GPT2Tokenizer : KernelBpeTokenizer {
   GPT2Tokenizer();
   // required by LiteCustomOp which neede a explicit Compute declaration for non-MSVC compiler.
-  OrtStatusPtr Compute(const ortc::Tensor<std::string>& input,
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
                        ortc::Tensor<int64_t>& tokenize_output,
                        std::optional<ortc::Tensor<int64_t>*> attention_mask,
                        std::optional<ortc::Tensor<int64_t>*> offset_mapping) const {
@@ -70,7 +70,7 @@ struct GPT2Tokenizer : KernelBpeTokenizer {
 struct RobertaTokenizer : KernelBpeTokenizer {
   RobertaTokenizer();
   // required by LiteCustomOp which neede a explicit Compute declaration for non-MSVC compiler.
-  OrtStatusPtr Compute(const ortc::Tensor<std::string>& input,
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
                        ortc::Tensor<int64_t>& tokenize_output,
                        std::optional<ortc::Tensor<int64_t>*> attention_mask,
                        std::optional<ortc::Tensor<int64_t>*> offset_mapping) const {
@@ -81,7 +81,7 @@ struct RobertaTokenizer : KernelBpeTokenizer {
 struct CLIPTokenizer : KernelBpeTokenizer {
   CLIPTokenizer();
   // required by LiteCustomOp which neede a explicit Compute declaration for non-MSVC compiler.
-  OrtStatusPtr Compute(const ortc::Tensor<std::string>& input,
+  OrtStatusPtr Compute(const ortc::Tensor<std::string_view>& input,
                        ortc::Tensor<int64_t>& tokenize_output,
                        std::optional<ortc::Tensor<int64_t>*> attention_mask,
                        std::optional<ortc::Tensor<int64_t>*> offset_mapping) const {
@@ -8,6 +8,7 @@
 #include <set>
 #include <map>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <sstream>
 #include <charconv>
@@ -31,7 +32,7 @@ class RWKVTrieTree : public ort_extensions::TrieTree<char> {
     Add(key, idx, value);
   }
 
-  int find_longest(const std::string& key, size_t& idx) {
+  int find_longest(std::string_view key, size_t& idx) {
     return FindLongest(key, idx);
   }
 };
@@ -77,7 +78,7 @@ class TrieTokenizer {
     }
   }
 
-  std::vector<int> encodeBytes(const std::string& src) {
+  std::vector<int> encodeBytes(std::string_view src) {
     size_t idx = 0;
     std::vector<int> tokens;
     while (idx < src.length()) {
@@ -108,14 +109,14 @@ struct KernelTrieTokenizer : public BaseKernel {
     tokenizer = std::make_shared<TrieTokenizer>(text_tokens);
   };
 
-  void Compute(const ortc::Tensor<std::string>& input,
+  void Compute(const ortc::Tensor<std::string_view>& input,
                ortc::Tensor<int64_t>& tokenize_output) const {
-    std::vector<std::string> str_input{input.Data()};
+    const auto& str_input = input.Data();
     const auto& input_dim = input.Shape();
 
     size_t max_length = 0;
     std::vector<std::vector<int64_t>> tokenize_results;
-    for (auto& str : str_input) {
+    for (auto str : str_input) {
       auto tokens = tokenizer->encodeBytes(str);
       std::vector<int64_t> tokens_int64(tokens.begin(), tokens.end());
       max_length = std::max(max_length, tokens_int64.size());
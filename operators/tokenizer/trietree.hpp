@@ -8,6 +8,7 @@
 #include <set>
 #include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 
 namespace ort_extensions {
@@ -36,7 +37,7 @@ class TrieTree {
     }
   }
 
-  ValueT FindLongest(const std::basic_string<CharT>& key, size_t& idx) const noexcept {
+  ValueT FindLongest(std::basic_string_view<CharT> key, size_t& idx) const noexcept {
     const TrieTree* u = this;
     CharT ch = key[idx];
 
@@ -132,7 +132,9 @@ void KernelWordpieceTokenizer::Compute(const ortc::Tensor<std::string>& input,
   std::vector<ustring> str_input;
   str_input.reserve(input.NumberOfElement());
   for (auto& str : input.Data()) {
-    str_input.emplace_back(str);
+    if (!ustring::DecodeUTF8(str, str_input.emplace_back())) {
+      ORTX_CXX_API_THROW("[WordpieceTokenizer]: input is not valid UTF-8.", ORT_INVALID_ARGUMENT);
+    }
   }
   const int64_t* p_row_indices = row_indices.Shape().empty() ? nullptr : row_indices.Data();
 
@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Throughput of the audio processing stages: decoding, channel mixing, lowpass filtering, resampling and the power
+// spectrum of the STFT frames. Every benchmark reports the samples processed per second and audio_s_per_s, the
+// seconds of audio processed per second. For the dashboards, write the results as JSON with
+//   audio_benchmark --benchmark_out=audio_benchmark.json --benchmark_out_format=json
+//
+// The corpora are the WAV, MP3 and FLAC files of test/data, and WAV streams of tones generated at 44.1 and 48 kHz
+// for 1, 10 and 30 seconds.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "audio/audio_decoder.hpp"
+#include "audio/channel_mixer.h"
+#include "audio/sampling.h"
+#include "fft.h"
+
+namespace {
+
+const int64_t kOutputRate = 16000;
+
+// Two tones, slightly different on every channel, as interleaved frames.
+std::vector<float> MakeSignal(int64_t rate, int64_t channels, int64_t seconds) {
+  std::vector<float> signal(static_cast<size_t>(rate * seconds * channels));
+  for (size_t i = 0; i < signal.size(); ++i) {
+    const double t = static_cast<double>(i / channels) / static_cast<double>(rate);
+    const double c = static_cast<double>(i % channels);
+    signal[i] = static_cast<float>(0.4 * std::sin(2.0 * M_PI * (440.0 + 10.0 * c) * t) +
+                                   0.2 * std::sin(2.0 * M_PI * 7000.0 * t));
+  }
+  return signal;
+}
+
+template <typename T>
+void Append(std::vector<uint8_t>& bytes, T value) {
+  const auto* p = reinterpret_cast<const uint8_t*>(&value);
+  bytes.insert(bytes.end(), p, p + sizeof(T));
+}
+
+// The signal as a 16-bit PCM WAV stream.
+std::vector<uint8_t> MakeWav(int64_t rate, int64_t channels, int64_t seconds) {
+  const std::vector<float> signal = MakeSignal(rate, channels, seconds);
+  const auto data_size = static_cast<uint32_t>(signal.size() * sizeof(int16_t));
+  std::vector<uint8_t> bytes;
+  bytes.reserve(44 + data_size);
+  bytes.insert(bytes.end(), {'R', 'I', 'F', 'F'});
+  Append<uint32_t>(bytes, 36 + data_size);
+  bytes.insert(bytes.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  Append<uint32_t>(bytes, 16);
+  Append<uint16_t>(bytes, 1);
+  Append<uint16_t>(bytes, static_cast<uint16_t>(channels));
+  Append<uint32_t>(bytes, static_cast<uint32_t>(rate));
+  Append<uint32_t>(bytes, static_cast<uint32_t>(rate * channels * 2));
+  Append<uint16_t>(bytes, static_cast<uint16_t>(channels * 2));
+  Append<uint16_t>(bytes, 16);
+  bytes.insert(bytes.end(), {'d', 'a', 't', 'a'});
+  Append<uint32_t>(bytes, data_size);
+  for (float v : signal) {
+    Append<int16_t>(bytes, static_cast<int16_t>(std::lround(v * 32767.0f)));
+  }
+  return bytes;
+}
+
+void SetThroughput(benchmark::State& state, size_t samples, double seconds) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(samples));
+  state.counters["audio_s_per_s"] = benchmark::Counter(seconds, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void Decode(benchmark::State& state, const std::vector<uint8_t>& bytes) {
+  AudioDecoder decoder;
+  std::vector<float> pcm;
+  int64_t rate = 0;
+  for (auto _ : state) {
+    OrtStatusPtr status = decoder.DecodeStream(bytes.data(), bytes.size(), std::string(), pcm, rate);
+    if (status != nullptr) {
+      OrtW::ReleaseStatus(status);
+      state.SkipWithError("the stream cannot be decoded");
+      return;
+    }
+    benchmark::DoNotOptimize(pcm.data());
+  }
+  SetThroughput(state, pcm.size(), rate > 0 ? static_cast<double>(pcm.size()) / static_cast<double>(rate) : 0.0);
+}
+
+// args: the sample rate, the number of channels and the duration in seconds.
+void BM_DecodeWav(benchmark::State& state) {
+  Decode(state, MakeWav(state.range(0), state.range(1), state.range(2)));
+}
+
+// A file of test/data, decoded to its interleaved channels at its own sample rate.
+void BM_DecodeFile(benchmark::State& state, const std::string& name) {
+  std::ifstream file(std::string(AUDIO_BENCHMARK_DATA_DIR) + "/" + name, std::ios::binary);
+  if (!file) {
+    state.SkipWithError(("cannot open " + name).c_str());
+    return;
+  }
+  Decode(state, std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {}));
+}
+
+// args: the number of channels and the duration in seconds, at 48 kHz; the channels are averaged.
+void BM_MixChannels(benchmark::State& state) {
+  const int64_t channels = state.range(0);
+  const std::vector<float> signal = MakeSignal(48000, channels, state.range(1));
+  const size_t num_frames = signal.size() / static_cast<size_t>(channels);
+  const ChannelMixer mixer = ChannelMixer::Average(static_cast<size_t>(channels));
+  std::vector<float> mono(num_frames);
+  for (auto _ : state) {
+    mixer.Process(signal.data(), num_frames, mono.data());
+    benchmark::DoNotOptimize(mono.data());
+  }
+  SetThroughput(state, signal.size(), static_cast<double>(state.range(1)));
+}
+
+// The same from the 16-bit samples of the WAV and FLAC decoders, converted as they are mixed.
+void BM_MixChannelsInt16(benchmark::State& state) {
+  const int64_t channels = state.range(0);
+  const std::vector<float> signal = MakeSignal(48000, channels, state.range(1));
+  std::vector<int16_t> samples(signal.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = static_cast<int16_t>(std::lround(signal[i] * 32767.0f));
+  }
+  const size_t num_frames = signal.size() / static_cast<size_t>(channels);
+  const ChannelMixer mixer = ChannelMixer::Average(static_cast<size_t>(channels));
+  std::vector<float> mono(num_frames);
+  for (auto _ : state) {
+    mixer.Process(samples.data(), num_frames, mono.data());
+    benchmark::DoNotOptimize(mono.data());
+  }
+  SetThroughput(state, signal.size(), static_cast<double>(state.range(1)));
+}
+
+// args: the sample rate and the duration in seconds; the cutoff is the Nyquist frequency of 16 kHz.
+void BM_Lowpass(benchmark::State& state) {
+  const std::vector<float> signal = MakeSignal(state.range(0), 1, state.range(1));
+  const ButterworthLowpass filter(0.5 * kOutputRate, static_cast<double>(state.range(0)));
+  std::vector<float> data(signal.size());
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::memcpy(data.data(), signal.data(), signal.size() * sizeof(float));
+    state.ResumeTiming();
+    filter.Process(data.data(), data.size());
+    benchmark::DoNotOptimize(data.data());
+  }
+  SetThroughput(state, signal.size(), static_cast<double>(state.range(1)));
+}
+
+// args: the sample rate and the duration in seconds, resampled to 16 kHz.
+void BM_Resample(benchmark::State& state) {
+  const std::vector<float> signal = MakeSignal(state.range(0), 1, state.range(1));
+  const PolyphaseResampler resampler(state.range(0), kOutputRate);
+  std::vector<float> output(resampler.OutputLength(signal.size()));
+  for (auto _ : state) {
+    resampler.Process(signal.data(), signal.size(), output.data());
+    benchmark::DoNotOptimize(output.data());
+  }
+  SetThroughput(state, signal.size(), static_cast<double>(state.range(1)));
+}
+
+// The lowpass filter and the resampling of AudioDecoder, in one pass.
+void BM_LowpassResample(benchmark::State& state) {
+  const std::vector<float> signal = MakeSignal(state.range(0), 1, state.range(1));
+  const ButterworthLowpass filter(0.5 * kOutputRate, static_cast<double>(state.range(0)));
+  const PolyphaseResampler resampler(state.range(0), kOutputRate);
+  std::vector<float> output(resampler.OutputLength(signal.size()));
+  for (auto _ : state) {
+    resampler.Process(signal.data(), signal.size(), filter, output.data());
+    benchmark::DoNotOptimize(output.data());
+  }
+  SetThroughput(state, signal.size(), static_cast<double>(state.range(1)));
+}
+
+// args: the duration in seconds at 16 kHz; the Whisper frames of 400 samples every 160 samples, Hann windowed.
+void BM_PowerSpectrum(benchmark::State& state) {
+  const int64_t n_fft = 400;
+  const int64_t hop_length = 160;
+  const std::vector<float> signal = MakeSignal(kOutputRate, 1, state.range(0));
+  std::vector<float> window(n_fft);
+  for (size_t i = 0; i < window.size(); ++i) {
+    window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(i) / n_fft));
+  }
+  const ort_extensions::FramePowerSpectrum spectrum(std::move(window));
+  auto workspace = spectrum.MakeWorkspace();
+  const auto length = static_cast<int64_t>(signal.size());
+  std::vector<float> power(spectrum.NumBins());
+  for (auto _ : state) {
+    for (int64_t center = 0; center <= length; center += hop_length) {
+      spectrum.Compute(signal.data(), length, center, power.data(), workspace);
+      benchmark::DoNotOptimize(power.data());
+    }
+  }
+  SetThroughput(state, signal.size(), static_cast<double>(state.range(0)));
+}
+
+void RateArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"rate", "seconds"});
+  for (int64_t rate : {44100, 48000}) {
+    for (int64_t seconds : {1, 10, 30}) {
+      b->Args({rate, seconds});
+    }
+  }
+}
+
+BENCHMARK(BM_DecodeWav)
+    ->ArgNames({"rate", "channels", "seconds"})
+    ->ArgsProduct({{44100, 48000}, {1, 2}, {1, 10, 30}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeFile, wav, std::string("1272-141231-0002.wav"))->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeFile, mp3, std::string("1272-141231-0002.mp3"))->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeFile, flac, std::string("1272-141231-0002.flac"))->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeFile, jfk_flac, std::string("jfk.flac"))->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MixChannels)
+    ->ArgNames({"channels", "seconds"})
+    ->ArgsProduct({{2, 4, 6}, {1, 10, 30}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MixChannelsInt16)
+    ->ArgNames({"channels", "seconds"})
+    ->ArgsProduct({{2, 4, 6}, {1, 10, 30}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Lowpass)->Apply(RateArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Resample)->Apply(RateArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LowpassResample)->Apply(RateArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PowerSpectrum)->ArgNames({"seconds"})->Arg(1)->Arg(10)->Arg(30)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
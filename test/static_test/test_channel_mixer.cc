@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "audio/channel_mixer.h"
+#include <vector>
+#include <cmath>
+#include <random>
+
+namespace {
+
+// The weighted sums of the channels of every frame, in double.
+template <typename T>
+std::vector<double> Reference(const std::vector<T>& input, const std::vector<float>& weights, float scale) {
+  const size_t channels = weights.size();
+  std::vector<double> expected(input.size() / channels);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    for (size_t c = 0; c < channels; ++c) {
+      expected[i] += static_cast<double>(weights[c]) * static_cast<double>(input[i * channels + c]) * scale;
+    }
+  }
+  return expected;
+}
+
+std::vector<float> RandomWeights(size_t channels, std::mt19937& engine) {
+  std::uniform_real_distribution<float> weight(-1.0f, 1.0f);
+  std::vector<float> weights(channels);
+  for (float& w : weights) {
+    w = weight(engine);
+  }
+  return weights;
+}
+
+}  // namespace
+
+// Every number of channels through every path of the de-interleaving, and the frames left over.
+TEST(ChannelMixerTest, FloatTest) {
+  std::mt19937 engine(5);
+  std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+  for (size_t channels = 1; channels <= 8; ++channels) {
+    for (size_t num_frames : {0, 3, 4, 37}) {
+      std::vector<float> input(channels * num_frames);
+      for (float& v : input) {
+        v = sample(engine);
+      }
+      const std::vector<float> weights = RandomWeights(channels, engine);
+      const std::vector<double> expected = Reference(input, weights, 1.0f);
+
+      std::vector<float> output(num_frames);
+      ChannelMixer(weights).Process(input.data(), num_frames, output.data());
+      for (size_t i = 0; i < num_frames; ++i) {
+        EXPECT_NEAR(expected[i], output[i], 1e-5) << channels << " channels differ at frame " << i;
+      }
+    }
+  }
+}
+
+TEST(ChannelMixerTest, Int16Test) {
+  std::mt19937 engine(9);
+  std::uniform_int_distribution<int> sample(-32768, 32767);
+  for (size_t channels = 1; channels <= 8; ++channels) {
+    const size_t num_frames = 41;
+    std::vector<int16_t> input(channels * num_frames);
+    for (int16_t& v : input) {
+      v = static_cast<int16_t>(sample(engine));
+    }
+    const std::vector<float> weights = RandomWeights(channels, engine);
+    const std::vector<double> expected = Reference(input, weights, 1.0f / 32768.0f);
+
+    std::vector<float> output(num_frames);
+    ChannelMixer(weights).Process(input.data(), num_frames, output.data());
+    for (size_t i = 0; i < num_frames; ++i) {
+      EXPECT_NEAR(expected[i], output[i], 1e-5) << channels << " channels differ at frame " << i;
+    }
+  }
+}
+
+// The 5.1 channels averaged in place, and one of them selected.
+TEST(ChannelMixerTest, SelectionTest) {
+  const size_t channels = 6;
+  const size_t num_frames = 10;
+  std::vector<float> input(channels * num_frames);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i % channels) + 0.01f * static_cast<float>(i / channels);
+  }
+
+  std::vector<float> center(num_frames);
+  ChannelMixer({0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f}).Process(input.data(), num_frames, center.data());
+  for (size_t i = 0; i < num_frames; ++i) {
+    EXPECT_FLOAT_EQ(input[i * channels + 2], center[i]);
+  }
+
+  std::vector<float> silent(num_frames, 1.0f);
+  ChannelMixer(std::vector<float>(channels, 0.0f)).Process(input.data(), num_frames, silent.data());
+  EXPECT_EQ(silent, std::vector<float>(num_frames, 0.0f));
+
+  const ChannelMixer average = ChannelMixer::Average(channels);
+  average.Process(input.data(), num_frames, input.data());
+  for (size_t i = 0; i < num_frames; ++i) {
+    EXPECT_NEAR(2.5f + 0.01f * static_cast<float>(i), input[i], 1e-5);
+  }
+}
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "fft.h"
+#include <cmath>
+#include <vector>
+
+// compares to the DFT computed in double, for lengths covering every butterfly and both the even and odd paths.
+TEST(RealFFTTest, MatchesDFT) {
+  for (size_t n : {1, 2, 7, 12, 30, 64, 97, 400, 401, 1024}) {
+    auto fft = ort_extensions::RealFFT::Get(n);
+    ASSERT_EQ(fft->NumBins(), n / 2 + 1);
+
+    std::vector<float> input(n);
+    for (size_t t = 0; t < n; ++t) {
+      input[t] = std::sin(0.37f * t) + 0.25f * std::cos(1.9f * t * t / n);
+    }
+    std::vector<float> output(2 * fft->NumBins());
+    std::vector<float> scratch(fft->ScratchSize());
+    fft->Forward(input.data(), output.data(), scratch.data());
+
+    for (size_t k = 0; k < fft->NumBins(); ++k) {
+      double re = 0.0;
+      double im = 0.0;
+      for (size_t t = 0; t < n; ++t) {
+        const double phase = -2.0 * M_PI * static_cast<double>(k * t % n) / static_cast<double>(n);
+        re += input[t] * std::cos(phase);
+        im += input[t] * std::sin(phase);
+      }
+      EXPECT_NEAR(output[2 * k], re, 1e-4 * n) << "n = " << n << ", bin " << k;
+      EXPECT_NEAR(output[2 * k + 1], im, 1e-4 * n) << "n = " << n << ", bin " << k;
+    }
+  }
+}
+
+TEST(FramePowerSpectrumTest, ReflectsAtTheEnds) {
+  // the frames on the first and the last samples read the signal mirrored around them.
+  const std::vector<float> signal = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  ort_extensions::FramePowerSpectrum spectrum(std::vector<float>(4, 1.0f));
+  auto workspace = spectrum.MakeWorkspace();
+  std::vector<float> power(spectrum.NumBins());
+
+  // [3, 2, 1, 2] and [5, 6, 5, 4]
+  spectrum.Compute(signal.data(), 6, 0, power.data(), workspace);
+  EXPECT_NEAR(power[0], 64.0f, 1e-4);
+  spectrum.Compute(signal.data(), 6, 5, power.data(), workspace);
+  EXPECT_NEAR(power[0], 400.0f, 1e-4);
+  // the Nyquist bin alternates the signs: 5 - 6 + 5 - 4
+  EXPECT_NEAR(power[2], 0.0f, 1e-4);
+}
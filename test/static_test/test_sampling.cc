@@ -42,3 +42,146 @@ TEST(ButterworthLowpassTest, FilterTest) {
     EXPECT_NEAR(expected[i], actual[i], 1e-05);
   }
 }
+
+// The cascade of sections is the filter of the direct form coefficients.
+TEST(ButterworthLowpassTest, SectionsTest) {
+  ButterworthLowpass filt(8000, 44100);
+  std::vector<double> num = {1.0};
+  std::vector<double> den = {1.0};
+  for (const auto& section : filt.GetSections()) {
+    std::vector<double> next_num(num.size() + 2), next_den(den.size() + 2);
+    const double b[3] = {section.b0, section.b1, section.b2};
+    const double a[3] = {1.0, section.a1, section.a2};
+    for (size_t i = 0; i < num.size(); ++i) {
+      for (size_t k = 0; k < 3; ++k) {
+        next_num[i + k] += num[i] * b[k];
+        next_den[i + k] += den[i] * a[k];
+      }
+    }
+    num.swap(next_num);
+    den.swap(next_den);
+  }
+
+  ASSERT_EQ(num.size(), filt.GetCoefs_B().size());
+  for (size_t i = 0; i < num.size(); ++i) {
+    EXPECT_NEAR(num[i], filt.GetCoefs_B()[i], 1e-6) << "at " << i;
+    EXPECT_NEAR(den[i], filt.GetCoefs_A()[i], 1e-6) << "at " << i;
+  }
+}
+
+// A signal long enough to be filtered in segments side by side comes out as through the direct form.
+TEST(ButterworthLowpassTest, LongSignalTest) {
+  ButterworthLowpass filt(8000, 48000);
+  std::vector<float> signal(100003);
+  for (size_t i = 0; i < signal.size(); ++i) {
+    signal[i] = static_cast<float>(std::sin(0.05 * i) + 0.3 * std::cos(2.9 * i));
+  }
+
+  const auto& b = filt.GetCoefs_B();
+  const auto& a = filt.GetCoefs_A();
+  std::vector<double> expected(signal.size());
+  for (size_t n = 0; n < signal.size(); ++n) {
+    double y = 0.0;
+    for (size_t k = 0; k < b.size() && k <= n; ++k) {
+      y += b[k] * signal[n - k] - (k > 0 ? a[k] * expected[n - k] : 0.0);
+    }
+    expected[n] = y;
+  }
+
+  std::vector<float> actual = filt.Process(signal);
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-5) << "at " << i;
+  }
+}
+
+TEST(PolyphaseResamplerTest, OutputLengthTest) {
+  EXPECT_EQ(PolyphaseResampler(44100, 16000).OutputLength(485100), 176000);
+  EXPECT_EQ(PolyphaseResampler(48000, 16000).OutputLength(10), 4);
+  EXPECT_EQ(PolyphaseResampler(16000, 16000).OutputLength(10), 10);
+  EXPECT_EQ(PolyphaseResampler(22050, 48000).OutputLength(0), 0);
+}
+
+// A tone below the output Nyquist frequency comes out unchanged, except near the ends where the filter
+// runs over the zeros outside the signal.
+TEST(PolyphaseResamplerTest, SineTest) {
+  const double kFrequency = 1000.0;
+  for (auto rates : {std::pair<int64_t, int64_t>{44100, 16000}, {48000, 16000}, {16000, 44100}, {44056, 16000}}) {
+    const int64_t input_rate = rates.first;
+    const int64_t output_rate = rates.second;
+    std::vector<float> signal(input_rate / 2);
+    for (size_t i = 0; i < signal.size(); ++i) {
+      signal[i] = static_cast<float>(std::sin(2 * M_PI * kFrequency * i / input_rate));
+    }
+
+    PolyphaseResampler resampler(input_rate, output_rate);
+    std::vector<float> output(resampler.OutputLength(signal.size()));
+    resampler.Process(signal.data(), signal.size(), output.data());
+    for (size_t i = 200; i + 200 < output.size(); ++i) {
+      EXPECT_NEAR(output[i], std::sin(2 * M_PI * kFrequency * i / output_rate), 2e-3)
+          << input_rate << " -> " << output_rate << " at " << i;
+    }
+  }
+}
+
+// Filtering and resampling a signal a chunk at a time gives the same samples as processing it at once.
+TEST(PolyphaseResamplerTest, ChunkedTest) {
+  std::vector<float> signal(30011);
+  for (size_t i = 0; i < signal.size(); ++i) {
+    signal[i] = static_cast<float>(std::sin(0.05 * i) + 0.3 * std::cos(0.31 * i));
+  }
+
+  ButterworthLowpass filter(8000, 44100);
+  PolyphaseResampler resampler(44100, 16000);
+  std::vector<float> filtered = signal;
+  filter.Process(filtered.data(), filtered.size());
+  std::vector<float> expected(resampler.OutputLength(signal.size()));
+  resampler.Process(filtered.data(), filtered.size(), expected.data());
+
+  ButterworthLowpass::History history{};
+  std::vector<float> buffer;  // the input samples from buffer_begin on, still needed by the next outputs
+  int64_t buffer_begin = 0;
+  std::vector<float> actual;
+  for (size_t pos = 0; pos < signal.size(); pos += 997) {
+    std::vector<float> chunk(signal.begin() + pos, signal.begin() + std::min(signal.size(), pos + 997));
+    filter.Process(chunk.data(), chunk.size(), history);
+    buffer.insert(buffer.end(), chunk.begin(), chunk.end());
+
+    const int64_t buffer_end = buffer_begin + static_cast<int64_t>(buffer.size());
+    const bool last = pos + 997 >= signal.size();
+    const uint64_t ready = last ? resampler.OutputLength(signal.size()) : resampler.ReadyOutputs(buffer_end);
+    const size_t done = actual.size();
+    actual.resize(ready);
+    resampler.Process(buffer.data(), buffer_begin, buffer.size(), done, ready, actual.data() + done);
+
+    const int64_t keep_from = std::max(buffer_begin, std::min(buffer_end, resampler.FirstInput(ready)));
+    buffer.erase(buffer.begin(), buffer.begin() + (keep_from - buffer_begin));
+    buffer_begin = keep_from;
+  }
+
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-6) << "at " << i;
+  }
+}
+
+// Resampling through the lowpass filter in one pass gives the samples of filtering first, and leaves the input as is.
+TEST(PolyphaseResamplerTest, FilteredTest) {
+  std::vector<float> signal(100003);
+  for (size_t i = 0; i < signal.size(); ++i) {
+    signal[i] = static_cast<float>(std::sin(0.05 * i) + 0.3 * std::cos(2.9 * i));
+  }
+
+  ButterworthLowpass filter(8000, 44100);
+  PolyphaseResampler resampler(44100, 16000);
+  std::vector<float> filtered = filter.Process(signal);
+  std::vector<float> expected(resampler.OutputLength(signal.size()));
+  resampler.Process(filtered.data(), filtered.size(), expected.data());
+
+  const std::vector<float> input = signal;
+  std::vector<float> actual(expected.size());
+  resampler.Process(signal.data(), signal.size(), filter, actual.data());
+  EXPECT_EQ(signal, input);
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-6) << "at " << i;
+  }
+}
@@ -5,8 +5,10 @@
 #include "string_utils.h"
 #ifdef ENABLE_RE2_REGEX
 #include "text/re2_strings/string_regex_split_re.hpp"
+#include "text/re2_strings/re2_cache.h"
 #endif
 #include "text/string_ecmaregex_split.hpp"
+#include "text/ecma_regex.h"
 
 TEST(strings, std_regex_test) {
   std::regex regex("[\u2700-\u27bf\U0001f650-\U0001f67f\U0001f600-\U0001f64f\u2600-\u26ff"
@@ -53,14 +55,27 @@ TEST(strings, regex_split_skip) {
 }
 #endif
 
+// Splits input with the ECMA regex kernel, into the tokens and their offsets.
+static void ECMARegexSplitTokens(const std::string& input, const std::string& pattern, const std::string& keep_pattern,
+                                 std::vector<std::string_view>& tokens, std::vector<int64_t>& begin_offsets,
+                                 std::vector<int64_t>& end_offsets) {
+  ort_extensions::ECMARegex reg(pattern, false);
+  ort_extensions::ECMARegex keep_reg(keep_pattern, false);
+  std::vector<std::pair<int64_t, int64_t>> spans;
+  ECMARegexSplit(input, reg, keep_pattern.empty() ? nullptr : &keep_reg, spans);
+  for (auto& span : spans) {
+    tokens.emplace_back(input.data() + span.first, span.second - span.first);
+    begin_offsets.push_back(span.first);
+    end_offsets.push_back(span.second);
+  }
+}
+
 TEST(strings, regex_split_no_matched) {
   std::string input = "helloworld";
-  std::regex reg("(\\s)");
-  std::regex keep_reg("");
   std::vector<std::string_view> tokens;
   std::vector<int64_t> begin_offsets;
   std::vector<int64_t> end_offsets;
-  ECMARegexSplitImpl(input, reg, true, keep_reg, tokens, begin_offsets, end_offsets);
+  ECMARegexSplitTokens(input, "(\\s)", "", tokens, begin_offsets, end_offsets);
   std::vector<std::string_view> expected_tokens{"helloworld"};
   std::vector<int64_t> expected_begin_offsets{0};
   std::vector<int64_t> expected_end_offsets{10};
@@ -71,12 +86,10 @@ TEST(strings, regex_split_no_matched) {
 
 TEST(strings, regex_split_begin_end_delim) {
   std::string input = " hello world ";
-  std::regex reg("(\\s)");
-  std::regex keep_reg("\\s");
   std::vector<std::string_view> tokens;
   std::vector<int64_t> begin_offsets;
   std::vector<int64_t> end_offsets;
-  ECMARegexSplitImpl(input, reg, true, keep_reg, tokens, begin_offsets, end_offsets);
+  ECMARegexSplitTokens(input, "(\\s)", "\\s", tokens, begin_offsets, end_offsets);
   std::vector<std::string_view> expected_tokens{" ", "hello"," ", "world", " "};
   std::vector<int64_t> expected_begin_offsets{0, 1, 6, 7, 12};
   std::vector<int64_t> expected_end_offsets{1, 6, 7, 12, 13};
@@ -84,3 +97,150 @@ TEST(strings, regex_split_begin_end_delim) {
   EXPECT_EQ(expected_begin_offsets, begin_offsets);
   EXPECT_EQ(expected_end_offsets, end_offsets);
 }
+
+// the same split when the pattern runs on std::regex, and when an empty match hands a row over to it.
+TEST(strings, regex_split_std_regex) {
+  std::string input = "ab1ab2";
+  std::vector<std::string_view> tokens;
+  std::vector<int64_t> begin_offsets;
+  std::vector<int64_t> end_offsets;
+  ECMARegexSplitTokens(input, "(ab)(?=\\d)", "ab", tokens, begin_offsets, end_offsets);
+  std::vector<std::string_view> expected_tokens{"ab", "1", "ab", "2"};
+  EXPECT_EQ(expected_tokens, tokens);
+
+  tokens.clear();
+  begin_offsets.clear();
+  end_offsets.clear();
+  ECMARegexSplitTokens("axa", "x*", "", tokens, begin_offsets, end_offsets);
+  std::vector<int64_t> expected_begin_offsets{0, 2};
+  std::vector<int64_t> expected_end_offsets{1, 3};
+  EXPECT_EQ(expected_begin_offsets, begin_offsets);
+  EXPECT_EQ(expected_end_offsets, end_offsets);
+}
+
+TEST(strings, string_views) {
+  const char chars[] = "helloworld!";
+  const size_t offsets[] = {0, 5, 5, 10, 11};
+  Ort::Custom::StringViews views(chars, offsets, 4);
+
+  ASSERT_EQ(views.size(), 4);
+  EXPECT_EQ(views[0], "hello");
+  EXPECT_TRUE(views[1].empty());
+  EXPECT_EQ(views[2], "world");
+  EXPECT_EQ(views.at(3), "!");
+
+  std::vector<std::string> copied(views.begin(), views.end());
+  EXPECT_EQ(copied, (std::vector<std::string>{"hello", "", "world", "!"}));
+  EXPECT_TRUE(Ort::Custom::StringViews().empty());
+}
+
+TEST(strings, string_tensor_builder) {
+  Ort::Custom::StringTensorBuilder builder;
+  builder.Reserve(3, 16);
+  builder.Append("first");
+  builder.Extend("sec");
+  builder.Extend('o');
+  builder.Extend("nd");
+  builder.EndElement();
+  builder.Extend("dropped");
+  builder.DropElement();
+  builder.Append("");
+
+  ASSERT_EQ(builder.size(), 3);
+  EXPECT_EQ(builder[0], "first");
+  EXPECT_EQ(builder[1], "second");
+  EXPECT_EQ(builder[2], "");
+  EXPECT_STREQ(builder.c_str(1), "second");
+}
+
+#ifdef ENABLE_RE2_REGEX
+TEST(strings, re2_cache) {
+  ort_extensions::RE2Cache cache(2);
+  auto a = cache.Get("a+");
+  EXPECT_TRUE(RE2::FullMatch("aaa", *a));
+  EXPECT_EQ(cache.Get("a+"), a);
+  EXPECT_EQ(cache.Hits(), 1);
+  EXPECT_EQ(cache.Misses(), 1);
+
+  RE2::Options icase;
+  icase.set_case_sensitive(false);
+  auto a_icase = cache.Get("a+", icase);
+  EXPECT_NE(a_icase, a);
+  EXPECT_TRUE(RE2::FullMatch("AaA", *a_icase));
+
+  // "a+" is the least recently used entry and gets evicted, but stays valid for its holder.
+  cache.Get("b+");
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_NE(cache.Get("a+"), a);
+  EXPECT_TRUE(RE2::FullMatch("aa", *a));
+
+  EXPECT_FALSE(cache.Get("(")->ok());
+  EXPECT_EQ(cache.Size(), 2);
+}
+#endif
+
+TEST(strings, ecma_regex_translation) {
+  std::string translated;
+  EXPECT_TRUE(ort_extensions::TranslateECMAScriptToRE2(R"(a.\s(?<name>\d+)\/)", false, translated));
+  EXPECT_EQ(translated, R"(a[^\n\r][\t\n\v\f\r ](?P<name>\d+)\/)");
+  EXPECT_TRUE(ort_extensions::TranslateECMAScriptToRE2("[]|[^]|[\\b[]", false, translated));
+  EXPECT_EQ(translated, R"([^\x{00}-\x{ff}]|[\x{00}-\x{ff}]|[\x{08}\[])");
+
+  EXPECT_FALSE(ort_extensions::TranslateECMAScriptToRE2(R"((a)\1)", false, translated));
+  EXPECT_FALSE(ort_extensions::TranslateECMAScriptToRE2("a(?=b)", false, translated));
+  EXPECT_FALSE(ort_extensions::TranslateECMAScriptToRE2("(?<!a)b", false, translated));
+  EXPECT_FALSE(ort_extensions::TranslateECMAScriptToRE2("\\u0100", false, translated));
+  EXPECT_FALSE(ort_extensions::TranslateECMAScriptToRE2("\xc3\xa9", true, translated));
+}
+
+TEST(strings, ecma_regex_replace) {
+  // the results must not depend on whether the pattern runs on RE2 or on std::regex.
+  for (auto pattern : {R"(def\s+([a-zA-Z_][a-zA-Z_0-9]*)\s*\(\s*\):)", R"(def\s+([a-zA-Z_]\w*)(?=\s*\()\s*\(\s*\):)"}) {
+    ort_extensions::ECMARegex reg(pattern, false);
+    std::string result;
+    reg.Replace("def f1():\n pass\ndef f2():\n pass", "static PyObject* py_$1(void) {", true, result);
+    EXPECT_EQ(result, "static PyObject* py_f1(void) {\n pass\nstatic PyObject* py_f2(void) {\n pass");
+    reg.Replace("def f1():\n pass\ndef f2():\n pass", "static PyObject* py_$1(void) {", false, result);
+    EXPECT_EQ(result, "static PyObject* py_f1(void) {\n pass\ndef f2():\n pass");
+  }
+
+  ort_extensions::ECMARegex icase("AB", true);
+  std::string result;
+  icase.Replace("xaBy", "[$&|$`|$'|$$|$9]", true, result);
+  EXPECT_EQ(result, "x[aB|x|y|$|]y");
+
+  // std::regex retries an empty match for a non-empty one at the same position.
+  for (auto pattern : {"a*?", "x*"}) {
+    ort_extensions::ECMARegex reg(pattern, false);
+    auto expected = std::regex_replace("axa", std::regex(pattern), "-");
+    reg.Replace("axa", "-", true, result);
+    EXPECT_EQ(result, expected);
+  }
+}
+
+TEST(strings, ecma_regex_matches) {
+  ort_extensions::ECMARegex reg("(\\s)", false);
+  ort_extensions::ECMARegex keep_reg("\\s", false);
+  std::vector<std::pair<size_t, size_t>> matches;
+  reg.ForEachMatch("hello  there\v", [&](size_t begin, size_t length) { matches.emplace_back(begin, length); });
+  std::vector<std::pair<size_t, size_t>> expected{{5, 1}, {6, 1}, {12, 1}};
+  EXPECT_EQ(matches, expected);
+  EXPECT_TRUE(keep_reg.FullMatch("\v"));
+  EXPECT_FALSE(keep_reg.FullMatch("  "));
+#ifdef ENABLE_RE2_REGEX
+  EXPECT_TRUE(reg.IsRE2());
+  EXPECT_FALSE(ort_extensions::ECMARegex("(a)\\1", false).IsRE2());
+#endif
+}
+
+#ifdef ENABLE_RE2_REGEX
+// std::regex rejects the named groups, RE2 runs them.
+TEST(strings, ecma_regex_named_group) {
+  ort_extensions::ECMARegex reg(R"((?<year>\d{4})-(?<month>\d\d))", false);
+  EXPECT_TRUE(reg.IsRE2());
+  std::string result;
+  reg.Replace("from 2023-11 to 2024-05", "$2/$1", true, result);
+  EXPECT_EQ(result, "from 11/2023 to 05/2024");
+  EXPECT_TRUE(reg.FullMatch("2024-05"));
+}
+#endif
@@ -7,6 +7,7 @@
 #include <codecvt>
 #include "gtest/gtest.h"
 #include "ustring.h"
+#include "case_map.h"
 
 void convert_test(const char* const_str) {
   std::string string(const_str);
@@ -67,3 +68,84 @@ TEST(ustring, operater) {
   test.append(U"用来测试");
   EXPECT_EQ(test.at(4), U'用');
 }
+
+TEST(ustring, validate_utf8) {
+  EXPECT_TRUE(ustring::ValidateUTF8(""));
+  EXPECT_TRUE(ustring::ValidateUTF8("plain ascii text that spans more than one 32-byte block"));
+  EXPECT_TRUE(ustring::ValidateUTF8("0123456789abcdef0123456789abcde中文"));
+  EXPECT_TRUE(ustring::ValidateUTF8("\xF4\x8F\xBF\xBF"));        // U+10FFFF
+  EXPECT_FALSE(ustring::ValidateUTF8("\xC0\xAF"));               // overlong '/'
+  EXPECT_FALSE(ustring::ValidateUTF8("\xE0\x80\xAF"));           // overlong '/'
+  EXPECT_FALSE(ustring::ValidateUTF8("\xED\xA0\x80"));           // surrogate
+  EXPECT_FALSE(ustring::ValidateUTF8("\xF4\x90\x80\x80"));       // above U+10FFFF
+  EXPECT_FALSE(ustring::ValidateUTF8("0123456789abcdef\xE4\xB8"));  // truncated at the end
+  EXPECT_FALSE(ustring::ValidateUTF8("\x80"));
+}
+
+TEST(ustring, decode_utf8) {
+  // mix ASCII runs of various lengths with multi-byte characters around the vector block boundaries.
+  std::string text;
+  for (int i = 0; i < 40; ++i) {
+    text += std::string(i, 'a') + "é中🧐";
+  }
+
+  ustring decoded;
+  ASSERT_TRUE(ustring::DecodeUTF8(text, decoded));
+  EXPECT_EQ(decoded.size(), 40 * 3 + 39 * 40 / 2);
+  EXPECT_EQ(std::string(decoded), text);
+  EXPECT_EQ(ustring(text), decoded);
+
+  EXPECT_FALSE(ustring::DecodeUTF8(text + "\xF0\x9F", decoded));
+  EXPECT_TRUE(decoded.empty());
+}
+
+TEST(ustring, invalid_utf8_is_replaced) {
+  ustring lossy(std::string("ab\xE4\xB8" "cd\xFF"));
+  EXPECT_EQ(lossy, ustring(U"ab�cd�"));
+}
+
+TEST(ustring, utf8_char_length) {
+  std::string text = "a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\xA7\x90\xFF\xE4\xB8";
+  std::vector<size_t> lengths;
+  for (size_t pos = 0; pos < text.size();) {
+    lengths.push_back(ort_extensions::UTF8CharLength(text.data() + pos, text.size() - pos));
+    pos += lengths.back();
+  }
+  // an invalid byte and a truncated sequence count as one character each.
+  EXPECT_EQ(lengths, (std::vector<size_t>{1, 2, 3, 4, 1, 2}));
+  EXPECT_EQ(ort_extensions::AsciiPrefixLength(text.data(), text.size()), 1);
+}
+
+TEST(ustring, count_utf8_code_points) {
+  // long enough to go through the vector loops and their tails.
+  std::string text;
+  for (int i = 0; i < 300; ++i) {
+    text += "abc\xC3\xA9\xE4\xB8\xAD\xF0\x9F\xA7\x90";
+  }
+  for (size_t len : {size_t(0), size_t(3), size_t(13), size_t(31), size_t(1000), text.size()}) {
+    ustring decoded(text.substr(0, len));
+    size_t expected = 0;
+    for (size_t i = 0; i < len; ++i) {
+      expected += (static_cast<unsigned char>(text[i]) & 0xC0) != 0x80;
+    }
+    EXPECT_EQ(ort_extensions::CountUTF8CodePoints(text.data(), len), expected);
+    if (len % 13 == 0) {
+      EXPECT_EQ(ort_extensions::CountUTF8CodePoints(text.data(), len), decoded.size());
+    }
+  }
+}
+
+TEST(ustring, case_map) {
+  // long ASCII runs go through the vector blocks, the accented letters through the UTF-8 table.
+  std::string text = "Hello WORLD, the Quick brown FOX [@`{] ÀÉÞ ß 漢字 and SOME more ASCII";
+  std::string lower(text.size(), '\0');
+  EXPECT_TRUE(ort_extensions::LowerCaseUTF8(text.data(), text.size(), &lower[0]));
+  EXPECT_EQ(lower, "hello world, the quick brown fox [@`{] àéþ ß 漢字 and some more ascii");
+
+  std::string upper(text.size(), '\0');
+  ort_extensions::UpperCaseAscii(text.data(), text.size(), &upper[0]);
+  EXPECT_EQ(upper, "HELLO WORLD, THE QUICK BROWN FOX [@`{] ÀÉÞ ß 漢字 AND SOME MORE ASCII");
+
+  std::string invalid = "ABC\xE4\xB8";
+  EXPECT_FALSE(ort_extensions::LowerCaseUTF8(invalid.data(), invalid.size(), &invalid[0]));
+}
@@ -1,6 +1,9 @@
 ﻿// Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
 #include "gtest/gtest.h"
 #ifdef ENABLE_RE2_REGEX
 #include "re2/re2.h"
@@ -8,6 +11,10 @@
 #include "nlohmann/json.hpp"
 #include "string_utils.h"
 #include "ustring.h"
+#include "op_arena.h"
+#include "thread_pool.h"
+#include "byte_set.h"
+#include "perfect_hash.h"
 
 
 TEST(utils, make_string) {
@@ -67,4 +74,106 @@ TEST(utils, utf8) {
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
     EXPECT_EQ(lowered[i], lower);
   }
-}
\ No newline at end of file
+}
+
+TEST(utils, compute_arena) {
+  Ort::Custom::ComputeArena arena;
+  auto mark = arena.GetMark();
+  {
+    Ort::Custom::ArenaVector<int64_t> values{Ort::Custom::ArenaAllocator<int64_t>(arena)};
+    for (int64_t i = 0; i < 100000; ++i) {
+      values.push_back(i);
+    }
+    EXPECT_EQ(values.back(), 99999);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(values.data()) % alignof(int64_t), 0);
+  }
+  EXPECT_GT(arena.BytesInUse(), 100000 * sizeof(int64_t));
+  auto peak = arena.PeakBytesInUse();
+
+  arena.Rewind(mark);
+  EXPECT_EQ(arena.BytesInUse(), 0);
+  EXPECT_EQ(arena.PeakBytesInUse(), peak);
+
+  // the retained blocks are reused after rewinding.
+  void* p1 = arena.Allocate(16, 16);
+  arena.Reset();
+  void* p2 = arena.Allocate(16, 16);
+  EXPECT_EQ(p1, p2);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p2) % 16, 0);
+}
+
+TEST(utils, thread_pool) {
+  ort_extensions::ThreadPool pool(4);
+  EXPECT_EQ(pool.NumThreads(), 4);
+
+  std::vector<int> visits(1000);
+  pool.ParallelFor(visits.size(), 7, [&](size_t begin, size_t end) {
+    EXPECT_LT(begin, end);
+    for (size_t i = begin; i < end; ++i) {
+      ++visits[i];
+      // a nested loop runs on the calling thread.
+      pool.ParallelFor(3, 1, [&](size_t, size_t) {});
+    }
+  });
+  EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), 1000);
+
+  size_t calls = 0;
+  pool.ParallelFor(0, 1, [&](size_t, size_t) { ++calls; });
+  EXPECT_EQ(calls, 0);
+}
+
+#ifndef OCOS_NO_EXCEPTIONS
+TEST(utils, thread_pool_exception) {
+  ort_extensions::ThreadPool pool(4);
+  std::atomic<size_t> visits{};
+  EXPECT_THROW(pool.ParallelFor(1000, 10, [&](size_t begin, size_t end) {
+    visits += end - begin;
+    if (begin <= 500 && 500 < end) {
+      throw std::runtime_error("chunk failed");
+    }
+  }), std::runtime_error);
+  EXPECT_LE(visits.load(), 1000);
+
+  // the pool runs the next loop after a failed one.
+  std::vector<int> values(100);
+  pool.ParallelFor(values.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      values[i] = 1;
+    }
+  });
+  EXPECT_EQ(std::count(values.begin(), values.end(), 1), 100);
+}
+#endif
+
+TEST(utils, byte_set) {
+  // long enough to go through the vector loops, with members in several high nibble groups.
+  std::string text = std::string(70, 'a') + "\t" + std::string(40, 'b') + "\xE9" + "c,";
+  ort_extensions::ByteSet separators(" \t,\xE9");
+  EXPECT_TRUE(separators.Contains(','));
+  EXPECT_FALSE(separators.Contains('a'));
+  EXPECT_EQ(separators.FindFirst(text.data(), text.size()), 70);
+  EXPECT_EQ(separators.FindFirst(text.data(), text.size(), 71), 111);
+  EXPECT_EQ(separators.FindFirst(text.data(), text.size(), 112), 113);
+  EXPECT_EQ(separators.FindFirst(text.data(), text.size(), 114), text.size());
+  EXPECT_EQ(ort_extensions::ByteSet("").FindFirst(text.data(), text.size()), text.size());
+}
+
+TEST(utils, perfect_hash_table) {
+  std::vector<std::string> words;
+  for (int i = 0; i < 1000; ++i) {
+    words.push_back("word" + std::to_string(i));
+  }
+  words.push_back("word7");  // a repeated key maps to its last position
+  words.push_back("");
+  std::vector<std::string_view> keys(words.begin(), words.end());
+
+  ort_extensions::PerfectHashTable table(keys);
+  EXPECT_EQ(table.size(), 1001);
+  for (size_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(table.Find(words[i]), i == 7 ? 1000 : i);
+  }
+  EXPECT_EQ(table.Find(""), 1001);
+  EXPECT_EQ(table.Find("word1000"), ort_extensions::PerfectHashTable::kNotFound);
+  EXPECT_EQ(table.Find("word"), ort_extensions::PerfectHashTable::kNotFound);
+  EXPECT_EQ(ort_extensions::PerfectHashTable().Find("word1"), ort_extensions::PerfectHashTable::kNotFound);
+}
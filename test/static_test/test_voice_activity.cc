@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "audio/voice_activity.h"
+#include <vector>
+#include <cmath>
+#include <random>
+
+namespace {
+
+const int64_t kRate = 16000;
+
+void AppendTone(std::vector<float>& signal, int64_t length, float amplitude) {
+  for (int64_t i = 0; i < length; ++i) {
+    signal.push_back(amplitude * static_cast<float>(std::sin(2.0 * M_PI * 300.0 * i / kRate)));
+  }
+}
+
+void AppendNoise(std::vector<float>& signal, int64_t length, float amplitude) {
+  std::mt19937 engine(7);
+  std::uniform_real_distribution<float> noise(-amplitude, amplitude);
+  for (int64_t i = 0; i < length; ++i) {
+    signal.push_back(noise(engine));
+  }
+}
+
+void AppendSilence(std::vector<float>& signal, int64_t length) {
+  signal.insert(signal.end(), static_cast<size_t>(length), 0.0f);
+}
+
+}  // namespace
+
+TEST(VoiceActivityDetectorTest, FrameFeaturesTest) {
+  std::mt19937 engine(3);
+  std::normal_distribution<float> noise(0.0f, 0.5f);
+  for (size_t n : {1, 2, 7, 8, 9, 480, 1001}) {
+    std::vector<float> frame(n);
+    for (float& v : frame) {
+      v = noise(engine);
+    }
+    double energy = 0.0;
+    int crossings = 0;
+    for (size_t i = 0; i < n; ++i) {
+      energy += frame[i] * frame[i];
+      crossings += i > 0 && std::signbit(frame[i]) != std::signbit(frame[i - 1]) ? 1 : 0;
+    }
+
+    float mean_square = 0.0f;
+    float zero_crossing_rate = 0.0f;
+    VoiceActivityDetector::FrameFeatures(frame.data(), n, mean_square, zero_crossing_rate);
+    EXPECT_NEAR(energy / n, mean_square, 1e-5) << "the mean square differs for n = " << n;
+    EXPECT_FLOAT_EQ(n > 1 ? static_cast<float>(crossings) / (n - 1) : 0.0f, zero_crossing_rate)
+        << "the zero-crossing rate differs for n = " << n;
+  }
+}
+
+// A tone between silences is speech, the white noise as loud is not.
+TEST(VoiceActivityDetectorTest, ToneAndNoiseTest) {
+  std::vector<float> signal;
+  AppendSilence(signal, kRate);
+  AppendTone(signal, kRate, 0.3f);
+  AppendSilence(signal, kRate);
+  AppendNoise(signal, kRate, 0.5f);
+  AppendSilence(signal, kRate);
+
+  VoiceActivityDetector::Options options;
+  VoiceActivityDetector detector(options);
+  const auto segments = detector.Detect(signal.data(), signal.size());
+  ASSERT_EQ(segments.size(), 1);
+  // the frames partly covering the tone are speech too.
+  EXPECT_LE(segments[0].first, kRate - options.padding);
+  EXPECT_GT(segments[0].first, kRate - options.padding - options.frame_length);
+  EXPECT_GE(segments[0].second, 2 * kRate + options.padding);
+  EXPECT_LT(segments[0].second, 2 * kRate + options.padding + options.frame_length);
+
+  AppendSilence(signal, kRate);
+  options.zero_crossing_threshold = 1.0f;
+  const auto with_noise = VoiceActivityDetector(options).Detect(signal.data(), signal.size());
+  EXPECT_EQ(with_noise.size(), 2);
+
+  std::vector<float> silence(10 * kRate);
+  EXPECT_TRUE(detector.Detect(silence.data(), silence.size()).empty());
+  EXPECT_TRUE(detector.Detect(silence.data(), 0).empty());
+}
+
+// The short pauses are joined, the short bursts dropped, and the padding clipped to the signal.
+TEST(VoiceActivityDetectorTest, PausesTest) {
+  VoiceActivityDetector::Options options;
+  options.frame_length = 400;
+  options.min_speech_length = 1600;
+  options.min_silence_length = 4000;
+  options.padding = 800;
+
+  std::vector<float> signal;
+  AppendTone(signal, 8000, 0.3f);
+  AppendSilence(signal, 2000);
+  AppendTone(signal, 8000, 0.3f);
+  AppendSilence(signal, 8000);
+  AppendTone(signal, 800, 0.3f);
+  AppendSilence(signal, 8000);
+  AppendTone(signal, 4000, 0.3f);
+
+  const auto segments = VoiceActivityDetector(options).Detect(signal.data(), signal.size());
+  ASSERT_EQ(segments.size(), 2);
+  EXPECT_EQ(segments[0], std::make_pair(int64_t{0}, int64_t{18000 + 800}));
+  EXPECT_EQ(segments[1], std::make_pair(int64_t{34800 - 800}, static_cast<int64_t>(signal.size())));
+}
+
+// A long segment is cut at the quiet frames closest to the window, into pieces of at most max_segment_length.
+TEST(VoiceActivityDetectorTest, MaxSegmentLengthTest) {
+  VoiceActivityDetector::Options options;
+  options.padding = 0;
+  options.max_segment_length = 30 * kRate;
+
+  std::vector<float> signal;
+  AppendTone(signal, 25 * kRate, 0.5f);
+  AppendTone(signal, kRate / 4, 0.05f);
+  AppendTone(signal, 25 * kRate, 0.5f);
+  AppendTone(signal, kRate / 4, 0.05f);
+  AppendTone(signal, 15 * kRate, 0.5f);
+
+  const auto segments = VoiceActivityDetector(options).Detect(signal.data(), signal.size());
+  ASSERT_EQ(segments.size(), 3);
+  EXPECT_EQ(segments[0].first, 0);
+  EXPECT_GE(segments[0].second, 25 * kRate);
+  EXPECT_LE(segments[0].second, 25 * kRate + kRate / 4);
+  EXPECT_GE(segments[1].second, 50 * kRate + kRate / 4);
+  EXPECT_LE(segments[1].second, 50 * kRate + kRate / 2);
+  for (size_t i = 1; i < segments.size(); ++i) {
+    EXPECT_EQ(segments[i].first, segments[i - 1].second);
+  }
+  EXPECT_EQ(segments.back().second, static_cast<int64_t>(signal.size()));
+  for (const auto& segment : segments) {
+    EXPECT_LE(segment.second - segment.first, options.max_segment_length);
+  }
+}
@@ -1,10 +1,12 @@
 # Copyright (c) Microsoft Corporation.
 # Licensed under the MIT License.
+import io
+import wave
 import unittest
 import numpy as np
 
 from onnx import checker, helper, onnx_pb as onnx_proto
-from onnxruntime_extensions import PyOrtFunction, util
+from onnxruntime_extensions import PyOrtFunction, util, ONNXRuntimeException
 
 
 class TestAudioCodec(unittest.TestCase):
@@ -55,6 +57,155 @@ class TestAudioCodec(unittest.TestCase):
         pcm_tensor = decoder(np.expand_dims(np.asarray(blob), axis=(0,)))
         self.assertEqual(pcm_tensor.shape, (1, 176000))
 
+    def test_multi_channel_decoder(self):
+        # a 5.1 recording, a different tone on every channel.
+        t = np.arange(4800) / 48000
+        channels = np.stack([0.1 * (c + 1) * np.sin(2 * np.pi * (200 + 50 * c) * t) for c in range(6)], axis=1)
+        samples = np.round(channels * 32767).astype(np.int16)
+        buffer = io.BytesIO()
+        with wave.open(buffer, 'wb') as f:
+            f.setnchannels(6)
+            f.setsampwidth(2)
+            f.setframerate(48000)
+            f.writeframes(samples.tobytes())
+        blob = np.expand_dims(np.frombuffer(buffer.getvalue(), dtype=np.uint8), axis=0)
+        channels = samples.astype(np.float32) / 32768
+
+        decoder = PyOrtFunction.from_customop('AudioDecoder', cpu_only=True, stereo_to_mono=1)
+        np.testing.assert_allclose(decoder(blob)[0], channels.mean(axis=1), atol=1e-5)
+
+        weights = [0.5, 0.5, 1.0, 0.0, 0.25, 0.25]
+        decoder = PyOrtFunction.from_customop('AudioDecoder', cpu_only=True, channel_weights=weights)
+        np.testing.assert_allclose(decoder(blob)[0], channels @ np.asarray(weights), atol=1e-5)
+
+        decoder = PyOrtFunction.from_customop(
+            'AudioDecoder', cpu_only=True, selected_channels=[2], downsampling_rate=16000)
+        self.assertEqual(decoder(blob).shape, (1, 1600))
+        decoder = PyOrtFunction.from_customop('AudioDecoder', cpu_only=True, selected_channels=[2])
+        np.testing.assert_allclose(decoder(blob)[0], channels[:, 2], atol=1e-6)
+
+    def test_batch_decoder(self):
+        files = [self.test_wav_file, util.get_test_data_file('data', 'jfk.flac'), self.test_mp3_file]
+        blobs = [np.frombuffer(util.read_file(f, mode='rb'), dtype=np.uint8) for f in files]
+        decoder = PyOrtFunction.from_customop(
+            'AudioDecoder', cpu_only=True, downsampling_rate=16000, stereo_to_mono=1)
+        expected = [decoder(np.expand_dims(blob, axis=(0,)))[0] for blob in blobs]
+
+        batch_decoder = PyOrtFunction.from_customop(
+            'BatchAudioDecoder', cpu_only=True, downsampling_rate=16000, stereo_to_mono=1)
+        row_splits = np.cumsum([0] + [len(blob) for blob in blobs]).astype(np.int64)
+        pcm, lengths = batch_decoder(np.concatenate(blobs), row_splits)
+        self.assertEqual(pcm.shape, (len(blobs), max(len(e) for e in expected)))
+        np.testing.assert_array_equal(lengths, [len(e) for e in expected])
+        for row, length, e in zip(pcm, lengths, expected):
+            np.testing.assert_allclose(row[:length], e)
+            np.testing.assert_array_equal(row[length:], 0)
+
+        string_decoder = PyOrtFunction.from_customop(
+            'BatchAudioDecoderFromStrings', cpu_only=True, downsampling_rate=16000, stereo_to_mono=1)
+        string_pcm, string_lengths = string_decoder(np.array([blob.tobytes() for blob in blobs], dtype=object))
+        np.testing.assert_array_equal(string_lengths, lengths)
+        np.testing.assert_allclose(string_pcm, pcm)
+
+    def test_streaming_decoder(self):
+        blob = np.frombuffer(util.read_file(self.test_wav_file, mode='rb'), dtype=np.uint8)
+        expected = self.decoder(np.expand_dims(blob, axis=(0,)))[0]
+        window = 16000
+        decoder = PyOrtFunction.from_customop('StreamingAudioDecoder', cpu_only=True, window_length=window)
+        state = np.zeros((0,), dtype=np.uint8)
+        windows = []
+        chunks = np.array_split(blob, 37)
+        for i, chunk in enumerate(chunks):
+            pcm, state = decoder(chunk, state, np.array(i + 1 == len(chunks)))
+            self.assertEqual(pcm.shape[1], window)
+            # the state only holds what is not emitted yet
+            self.assertLess(state.shape[0], 8 * window)
+            windows.append(pcm)
+        pcm = np.concatenate(windows).reshape(-1)
+        self.assertEqual(pcm.shape[0], (expected.shape[0] + window - 1) // window * window)
+        np.testing.assert_allclose(pcm[:expected.shape[0]], expected)
+        np.testing.assert_array_equal(pcm[expected.shape[0]:], 0)
+
+    def test_streaming_decoder_resampling(self):
+        # a stereo recording at 48 kHz, mixed down and resampled to 16 kHz, so that the lowpass filter and the
+        # resampler carry their history from one chunk to the next.
+        t = np.arange(48000 * 2) / 48000
+        rng = np.random.default_rng(7)
+        channels = np.stack([0.3 * np.sin(2 * np.pi * 440 * t), 0.2 * np.sin(2 * np.pi * 3000 * t)], axis=1)
+        channels += 0.05 * rng.standard_normal(channels.shape)
+        samples = np.round(np.clip(channels, -1, 1) * 32767).astype(np.int16)
+        buffer = io.BytesIO()
+        with wave.open(buffer, 'wb') as f:
+            f.setnchannels(2)
+            f.setsampwidth(2)
+            f.setframerate(48000)
+            f.writeframes(samples.tobytes())
+        blob = np.frombuffer(buffer.getvalue(), dtype=np.uint8)
+
+        attrs = dict(cpu_only=True, downsampling_rate=16000, stereo_to_mono=1)
+        expected = PyOrtFunction.from_customop('AudioDecoder', **attrs)(np.expand_dims(blob, axis=(0,)))[0]
+        self.assertEqual(expected.shape, (32000,))
+
+        decoder = PyOrtFunction.from_customop('StreamingAudioDecoder', **attrs)
+        state = np.zeros((0,), dtype=np.uint8)
+        outputs = []
+        # odd chunk sizes, which split the frames and the samples of the WAV data.
+        bounds = np.cumsum(np.resize([997, 13, 4099, 1], len(blob) // 1000))
+        bounds = np.concatenate([[0], bounds[bounds < len(blob)], [len(blob)]])
+        for i, (begin, end) in enumerate(zip(bounds[:-1], bounds[1:])):
+            pcm, state = decoder(blob[begin:end], state, np.array(i + 2 == len(bounds)))
+            outputs.append(pcm.reshape(-1))
+        pcm = np.concatenate(outputs)
+        self.assertEqual(pcm.shape, expected.shape)
+        np.testing.assert_allclose(pcm, expected, atol=1e-5)
+
+    def test_streaming_mp3_decoder(self):
+        blob = np.frombuffer(util.read_file(self.test_mp3_file, mode='rb'), dtype=np.uint8)
+        expected = self.decoder(np.expand_dims(blob, axis=(0,)))[0]
+        # an ID3v2 tag of 2048 bytes in front of the frames, its size as 4 bytes of 7 bits.
+        id3_tag = np.zeros((10 + 2048,), dtype=np.uint8)
+        id3_tag[:10] = [ord('I'), ord('D'), ord('3'), 4, 0, 0, 0, 0, 0x10, 0]
+        decoder = PyOrtFunction.from_customop('StreamingAudioDecoder', cpu_only=True)
+        # chunks of about 1000 bytes end inside the MP3 frames, and in the middle of the tag.
+        for stream in (blob, np.concatenate([id3_tag, blob])):
+            state = np.zeros((0,), dtype=np.uint8)
+            outputs = []
+            chunks = np.array_split(stream, len(stream) // 1000)
+            for i, chunk in enumerate(chunks):
+                pcm, state = decoder(chunk, state, np.array(i + 1 == len(chunks)))
+                outputs.append(pcm.reshape(-1))
+            pcm = np.concatenate(outputs)
+            self.assertEqual(pcm.shape, expected.shape)
+            np.testing.assert_allclose(pcm, expected, atol=1e-6)
+
+    def test_streaming_decoder_tampered_state(self):
+        blob = np.frombuffer(util.read_file(self.test_mp3_file, mode='rb'), dtype=np.uint8)
+        decoder = PyOrtFunction.from_customop('StreamingAudioDecoder', cpu_only=True)
+        _, state = decoder(blob[:30000], np.zeros((0,), dtype=np.uint8), np.array(False))
+        decoder(blob[30000:40000], state, np.array(False))
+
+        # the bytes of the decoded MP3 frames to decode again, a uint64 at offset 48, beyond the bytes of the state.
+        tampered = state.copy()
+        tampered[48:56] = np.frombuffer(np.uint64(len(state)).tobytes(), dtype=np.uint8)
+        self.assertRaises(ONNXRuntimeException, decoder, blob[30000:40000], tampered, np.array(False))
+        # a state of the format that held the minimp3 decoder, "ASD2".
+        tampered = state.copy()
+        tampered[:4] = np.frombuffer(b'ASD2', dtype=np.uint8)
+        self.assertRaises(ONNXRuntimeException, decoder, blob[30000:40000], tampered, np.array(False))
+        self.assertRaises(ONNXRuntimeException, decoder, blob[30000:40000], state[:-1], np.array(False))
+
+    def test_resample(self):
+        resampler = PyOrtFunction.from_customop(
+            'Resample', cpu_only=True, orig_sample_rate=48000, target_sample_rate=16000)
+        t = np.arange(48000, dtype=np.float32) / 48000
+        waveform = np.stack([np.sin(2 * np.pi * 1000 * t), np.ones_like(t)]).astype(np.float32)
+        resampled = resampler(waveform)
+        self.assertEqual(resampled.shape, (2, 16000))
+        # away from the ends, the tone and the constant signal are kept
+        expected = np.sin(2 * np.pi * 1000 * np.arange(16000) / 16000)
+        np.testing.assert_allclose(resampled[0, 200:-200], expected[200:-200], atol=2e-3)
+        np.testing.assert_allclose(resampled[1, 200:-200], 1.0, atol=1e-5)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -103,7 +103,35 @@ class TestAudio(unittest.TestCase):
         ortx_stft = OrtPyFunction.from_customop("StftNorm", cpu_only=True)
         actual = ortx_stft(np.expand_dims(audio_pcm, axis=0), 400, 160, np.hanning(400).astype(np.float32), 400)
         actual = actual[0]
-        np.testing.assert_allclose(expected[:, 1:], actual[:, 1:], rtol=1e-3, atol=1e-3)
+        np.testing.assert_allclose(expected, actual, rtol=1e-3, atol=1e-3)
+
+    def test_stft_norm_batch(self):
+        # a batch of two waveforms, and a window shorter than n_fft, centered in the frame
+        waveforms = np.stack([self.test_pcm, self.test_pcm[::-1]]).astype(np.float32)
+        window = np.hanning(300).astype(np.float32)
+        padded_window = np.pad(window, (50, 50))
+        expected = np.stack([self.stft(waveform, 400, 160, padded_window) for waveform in waveforms])
+
+        ortx_stft = OrtPyFunction.from_customop("StftNorm", cpu_only=True)
+        actual = ortx_stft(waveforms, 400, 160, window, 300)
+        self.assertEqual(actual.shape, (2, 201, waveforms.shape[1] // 160 + 1))
+        np.testing.assert_allclose(expected, actual, rtol=1e-3, atol=1e-3)
+
+    def test_stft_norm_odd_n_fft(self):
+        # torch.stft pads n_fft // 2 samples on both sides, one less than a frame for an odd n_fft, so a signal of
+        # 200 hops has 200 frames, not 201.
+        n_fft, hop_length = 401, 160
+        waveform = self.test_pcm[:200 * hop_length].astype(np.float32)
+        window = np.hanning(n_fft).astype(np.float32)
+        padded = np.pad(waveform, n_fft // 2, mode="reflect")
+        num_frames = 1 + (len(padded) - n_fft) // hop_length
+        frames = np.stack([padded[f * hop_length:f * hop_length + n_fft] for f in range(num_frames)])
+        expected = (np.abs(np.fft.rfft(frames * window, axis=1)) ** 2).T
+
+        ortx_stft = OrtPyFunction.from_customop("StftNorm", cpu_only=True)
+        actual = ortx_stft(np.expand_dims(waveform, axis=0), n_fft, hop_length, window, n_fft)
+        self.assertEqual(actual.shape, (1, n_fft // 2 + 1, 200))
+        np.testing.assert_allclose(expected, actual[0], rtol=1e-3, atol=1e-3)
 
     @unittest.skipIf(not _is_torch_available, "PyTorch is not available")
     def test_stft_norm_torch(self):
@@ -121,6 +149,44 @@ class TestAudio(unittest.TestCase):
         actual = actual[0]
         np.testing.assert_allclose(expected[:, 1:], actual[:, 1:], rtol=1e-3, atol=1e-3)
 
+    def test_log_mel_spectrogram(self):
+        waveforms = np.stack([self.test_pcm, 0.5 * self.test_pcm[::-1]]).astype(np.float32)
+        # the Whisper preprocessing: a periodic Hann window, the last frame dropped, and a dynamic range of 8.
+        window = np.hanning(401)[:-1].astype(np.float32)
+        mel_filters = util.mel_filterbank(400, 80, 16000)
+        expected = []
+        for waveform in waveforms:
+            power = self.stft(waveform, 400, 160, window)[:, :-1]
+            log_spec = np.log10(np.maximum(mel_filters @ power, 1e-10))
+            expected.append(np.maximum(log_spec, log_spec.max() - 8.0))
+
+        log_mel = OrtPyFunction.from_customop(
+            "LogMelSpectrogram", cpu_only=True, n_fft=400, hop_length=160, n_mels=80, sample_rate=16000,
+            dynamic_range=8.0)
+        actual = log_mel(waveforms)
+        self.assertEqual(actual.shape, (2, 80, waveforms.shape[1] // 160))
+        np.testing.assert_allclose(np.stack(expected), actual, rtol=1e-3, atol=1e-3)
+
+        # the scaling of the Whisper feature extractor, in the op.
+        whisper_log_mel = OrtPyFunction.from_customop(
+            "LogMelSpectrogram", cpu_only=True, n_fft=400, hop_length=160, n_mels=80, sample_rate=16000,
+            dynamic_range=8.0, whisper_normalize=1)
+        np.testing.assert_allclose((actual + 4.0) / 4.0, whisper_log_mel(waveforms), rtol=1e-6, atol=1e-6)
+
+    def test_speech_segment_extraction(self):
+        t = np.arange(16000) / 16000
+        tone = 0.3 * np.sin(2 * np.pi * 300 * t)
+        silence = np.zeros(16000)
+        pcm = np.concatenate([silence, tone, silence, silence, tone, silence]).astype(np.float32)
+
+        vad = OrtPyFunction.from_customop(
+            "SpeechSegmentExtraction", cpu_only=True, frame_length=400, min_speech_length=1600,
+            min_silence_length=8000, padding=800)
+        position = vad(np.expand_dims(pcm, axis=0))
+        np.testing.assert_array_equal(position, [[16000 - 800, 32000 + 800], [64000 - 800, 80000 + 800]])
+        for start, end in position:
+            self.assertGreater(np.abs(pcm[start:end]).max(), 0.29)
+
     @unittest.skipIf(not _is_librosa_available, "librosa is not available")
     def test_mel_filter_bank(self):
         expected = librosa.filters.mel(n_fft=400, n_mels=80, sr=16000)
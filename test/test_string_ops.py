@@ -847,6 +847,33 @@ class TestPythonOpString(unittest.TestCase):
         self.assertEqual(exp.shape, txout[0].shape)
         self.assertEqual(exp.tolist(), txout[0].tolist())
 
+    def test_string_to_hash_bucket_multi_seed_cc(self):
+        so = _ort.SessionOptions()
+        so.register_custom_ops_library(_get_library_path())
+        node = helper.make_node(
+            'StringToHashBucketMultiSeed', ['text', 'num_buckets'], ['customout'],
+            domain='ai.onnx.contrib', seeds=[0xDECAFCAFFE, 0, 42])
+        input0 = helper.make_tensor_value_info(
+            'text', onnx_proto.TensorProto.STRING, [None, None])
+        input1 = helper.make_tensor_value_info(
+            'num_buckets', onnx_proto.TensorProto.INT64, [1])
+        output0 = helper.make_tensor_value_info(
+            'customout', onnx_proto.TensorProto.INT64, [None, None, 3])
+        graph = helper.make_graph([node], 'test0', [input0, input1], [output0])
+        onnx_model = make_onnx_model(graph)
+        sess = _ort.InferenceSession(onnx_model.SerializeToString(), so, providers=['CPUExecutionProvider'])
+        raw = ["abc", "abcdé", "$$^l!%*ù", "", "a", "A"]
+        text = np.array(raw).reshape((3, 2))
+        num_buckets = np.array([NUM_BUCKETS], dtype=np.int64)
+        txout = sess.run(
+            None, {'text': text, 'num_buckets': num_buckets})
+        # the first seed is the one of StringToHashBucket.
+        exp = np.array([[[15, 11, 21], [11, 14, 2]],
+                        [[10, 9, 13], [21, 0, 17]],
+                        [[20, 10, 4], [21, 8, 20]]], dtype=np.int64)
+        self.assertEqual(exp.shape, txout[0].shape)
+        self.assertEqual(exp.tolist(), txout[0].tolist())
+
     def test_string_to_hash_bucket_python(self):
         so = _ort.SessionOptions()
         so.register_custom_ops_library(_get_library_path())
@@ -907,6 +934,44 @@ class TestPythonOpString(unittest.TestCase):
             txout = sess.run(None, {'x': y, 'y': x})
             self.assertEqual(txout[0].tolist(), (y == x).tolist())
 
+    def test_string_ragged_tensor_to_dense_cc(self):
+        so = _ort.SessionOptions()
+        so.register_custom_ops_library(_get_library_path())
+        node = helper.make_node(
+            'StringRaggedTensorToDense', ['shape', 'values', 'row_splits', 'default'], ['dense'],
+            domain='ai.onnx.contrib')
+        graph = helper.make_graph(
+            [node], 'test0',
+            [helper.make_tensor_value_info('shape', onnx_proto.TensorProto.INT64, [None]),
+             helper.make_tensor_value_info('values', onnx_proto.TensorProto.STRING, [None]),
+             helper.make_tensor_value_info('row_splits', onnx_proto.TensorProto.INT64, [None]),
+             helper.make_tensor_value_info('default', onnx_proto.TensorProto.STRING, [None])],
+            [helper.make_tensor_value_info('dense', onnx_proto.TensorProto.STRING, [None, None])])
+        sess = _ort.InferenceSession(make_onnx_model(graph).SerializeToString(), so,
+                                     providers=['CPUExecutionProvider'])
+        row_splits = np.array([0, 2, 2, 5], dtype=np.int64)
+        txout = sess.run(None, {'shape': np.array([-1, -1], dtype=np.int64),
+                                'values': np.array(["a", "bc", "déf", "", "g"]),
+                                'row_splits': row_splits,
+                                'default': np.array([""] * len(row_splits))})
+        self.assertEqual([["a", "bc", ""], ["", "", ""], ["déf", "", "g"]], txout[0].tolist())
+
+    def test_string_equal_long_strings_cc(self):
+        so = _ort.SessionOptions()
+        so.register_custom_ops_library(_get_library_path())
+        onnx_model = _create_test_model_string_equal('')
+        sess = _ort.InferenceSession(onnx_model.SerializeToString(), so, providers=['CPUExecutionProvider'])
+
+        # strings sharing their length and first 8 bytes, on both sides of the broadcast.
+        words = np.array(["", "label", "label_00", "label_001", "label_002", "label_0010"])
+        x = words[np.random.randint(0, len(words), size=(4, 50, 60))]
+        for y in [np.array(["label_001"]), words[np.random.randint(0, len(words), size=(4, 1, 60))],
+                  words[np.random.randint(0, len(words), size=(4, 50, 1))], x.copy()]:
+            txout = sess.run(None, {'x': x, 'y': y})
+            self.assertEqual(txout[0].tolist(), (x == y).tolist())
+            txout = sess.run(None, {'x': y, 'y': x})
+            self.assertEqual(txout[0].tolist(), (y == x).tolist())
+
     def test_string_split_python(self):
         so = _ort.SessionOptions()
         so.register_custom_ops_library(_get_library_path())
@@ -1081,6 +1146,82 @@ class TestPythonOpString(unittest.TestCase):
                 self.assertEqual(exp_indices.tolist(), txout[0].tolist())
                 self.assertEqual(exp_shape.tolist(), txout[2].tolist())
 
+    def test_string_split_cc_sep0_utf8(self):
+        so = _ort.SessionOptions()
+        so.register_custom_ops_library(_get_library_path())
+        onnx_model = _create_test_model_string_split('')
+        sess = _ort.InferenceSession(onnx_model.SerializeToString(), so, providers=['CPUExecutionProvider'])
+        input = np.array(["aé", "", "中文b"])
+        txout = sess.run(
+            None, {'input': input, 'delimiter': np.array([""]),
+                   'skip_empty': np.array([True])})
+
+        # the characters are not cut in the middle of their UTF-8 encoding.
+        self.assertEqual(['a', 'é', '中', '文', 'b'], txout[1].tolist())
+        self.assertEqual([[0, 0], [0, 1], [2, 0], [2, 1], [2, 2]], txout[0].tolist())
+        self.assertEqual([3, 3], txout[2].tolist())
+
+    def test_text_pipeline_cc(self):
+        so = _ort.SessionOptions()
+        so.register_custom_ops_library(_get_library_path())
+        domain = 'ai.onnx.contrib'
+        input = np.array(["Hello World", "", "ABC  dEf", "Été, fin"])
+        for mapping, hash_op in [('hash', 'StringToHashBucket'),
+                                 ('hash_fast', 'StringToHashBucketFast')]:
+            with self.subTest(mapping=mapping):
+                fused = helper.make_node(
+                    'TextPipeline', ['input'], ['ids', 'row_splits'], domain=domain,
+                    steps='lower,regex_replace,split', regex_pattern='[aeiou]',
+                    regex_rewrite='_', sep=' ,', skip_empty=1,
+                    mapping=mapping, num_buckets=NUM_BUCKETS)
+                unfused = [
+                    helper.make_node('StringLower', ['input'], ['lower'], domain=domain),
+                    helper.make_node('StringRegexReplace', ['lower', 'pattern', 'rewrite'],
+                                     ['replaced'], domain=domain),
+                    helper.make_node('StringSplit', ['replaced', 'sep', 'skip_empty'],
+                                     ['indices', 'pieces', 'shape'], domain=domain),
+                    helper.make_node(hash_op, ['pieces', 'num_buckets'], ['hashes'], domain=domain)]
+                initializers = [
+                    helper.make_tensor('pattern', onnx_proto.TensorProto.STRING, [1], [b'[aeiou]']),
+                    helper.make_tensor('rewrite', onnx_proto.TensorProto.STRING, [1], [b'_']),
+                    helper.make_tensor('sep', onnx_proto.TensorProto.STRING, [1], [b' ,']),
+                    helper.make_tensor('skip_empty', onnx_proto.TensorProto.BOOL, [1], [True]),
+                    helper.make_tensor('num_buckets', onnx_proto.TensorProto.INT64, [1], [NUM_BUCKETS])]
+                int_output = lambda name: helper.make_tensor_value_info(
+                    name, onnx_proto.TensorProto.INT64, None)
+                graph = helper.make_graph(
+                    [fused] + unfused, 'test0',
+                    [helper.make_tensor_value_info('input', onnx_proto.TensorProto.STRING, [None])],
+                    [int_output('ids'), int_output('row_splits'), int_output('indices'),
+                     int_output('hashes')],
+                    initializers)
+                sess = _ort.InferenceSession(make_onnx_model(graph).SerializeToString(), so,
+                                             providers=['CPUExecutionProvider'])
+                ids, row_splits, indices, hashes = sess.run(None, {'input': input})
+
+                # identical to the unfused chain.
+                self.assertEqual(hashes.tolist(), ids.tolist())
+                counts = np.bincount(indices[:, 0], minlength=len(input))
+                self.assertEqual([0] + np.cumsum(counts).tolist(), row_splits.tolist())
+                self.assertEqual([0, 2, 2, 4, 6], row_splits.tolist())
+
+    def test_text_pipeline_lookup_cc(self):
+        so = _ort.SessionOptions()
+        so.register_custom_ops_library(_get_library_path())
+        node = helper.make_node(
+            'TextPipeline', ['input'], ['ids', 'row_splits'], domain='ai.onnx.contrib',
+            steps='lower,split', mapping='lookup', map='hello\t1\nworld\t2', unk='0')
+        graph = helper.make_graph(
+            [node], 'test0',
+            [helper.make_tensor_value_info('input', onnx_proto.TensorProto.STRING, [None])],
+            [helper.make_tensor_value_info('ids', onnx_proto.TensorProto.INT64, [None]),
+             helper.make_tensor_value_info('row_splits', onnx_proto.TensorProto.INT64, [None])])
+        sess = _ort.InferenceSession(make_onnx_model(graph).SerializeToString(), so,
+                                     providers=['CPUExecutionProvider'])
+        ids, row_splits = sess.run(None, {'input': np.array(["Hello World", "", "hello there"])})
+        self.assertEqual([1, 2, 1, 0], ids.tolist())
+        self.assertEqual([0, 2, 2, 4], row_splits.tolist())
+
     def test_string_regex_split_cc(self):
         so = _ort.SessionOptions()
         so.register_custom_ops_library(_get_library_path())
@@ -32,6 +32,7 @@ CMAKE_FLAG_TO_OPS = {
     ],
     "OCOS_ENABLE_MATH": [
         "SegmentExtraction",
+        "StftNorm",
     ],
     "OCOS_ENABLE_OPENCV_CODECS": [
         "DecodeImage",
@@ -59,8 +60,10 @@ CMAKE_FLAG_TO_OPS = {
         "StringSplit",
         "StringToHashBucket",
         "StringToHashBucketFast",
+        "StringToHashBucketMultiSeed",
         "StringToVector",
         "StringUpper",
+        "TextPipeline",
         "VectorToString",
     ],
     "OCOS_ENABLE_VISION": [
@@ -72,11 +75,16 @@ CMAKE_FLAG_TO_OPS = {
         "WordpieceTokenizer",
     ],
     "OCOS_ENABLE_AUDIO": [
-        "AudioDecoder"
+        "AudioDecoder",
+        "BatchAudioDecoder",
+        "BatchAudioDecoderFromStrings",
+        "LogMelSpectrogram",
+        "Resample",
+        "SpeechSegmentExtraction",
+        "StreamingAudioDecoder",
     ],
     "OCOS_ENABLE_DLIB": [
         "Inverse",
-        "StftNorm"
     ],
     "OCOS_ENABLE_TRIE_TOKENIZER": [
         "TrieTokenizer",